@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "cc"
+#include "cc_arena.h"
+#include "cc_log.h"
+#include "cc_memory.h"
+
+#define CC_ARENA_ALIGN      16
+#define CC_ARENA_BLOCK_SIZE 65536
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+typedef struct cc_arenaBlock_s
+{
+	cc_arenaBlock_t* next;
+	size_t           size;
+	// uint8_t       data[];
+} cc_arenaBlock_t;
+
+static uint8_t* cc_arenaBlock_data(cc_arenaBlock_t* self)
+{
+	ASSERT(self);
+
+	return (uint8_t*)
+	       (((void*) self) + sizeof(cc_arenaBlock_t));
+}
+
+static cc_arenaBlock_t* cc_arenaBlock_new(size_t size)
+{
+	cc_arenaBlock_t* self;
+	self = (cc_arenaBlock_t*)
+	       MALLOC_TAG(CC_MEMTAG_ARENA,
+	                  sizeof(cc_arenaBlock_t) + size);
+	if(self == NULL)
+	{
+		LOGE("MALLOC_TAG failed");
+		return NULL;
+	}
+
+	self->next = NULL;
+	self->size = size;
+
+	return self;
+}
+
+static void* cc_arenaBlock_alloc(cc_arenaBlock_t* self,
+                                 size_t* _offset,
+                                 size_t size)
+{
+	ASSERT(self);
+	ASSERT(_offset);
+
+	// align the allocation relative to the address since
+	// MALLOC only guarantees the platform alignment
+	uint8_t*  data = cc_arenaBlock_data(self);
+	uintptr_t addr = (uintptr_t) (data + *_offset);
+	size_t    pad  = (size_t) ((-addr) & (CC_ARENA_ALIGN - 1));
+
+	size_t offset = *_offset + pad;
+	if((offset > self->size) || (size > self->size - offset))
+	{
+		return NULL;
+	}
+
+	*_offset = offset + size;
+
+	return (void*) (data + offset);
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_arena_t* cc_arena_new(size_t block_size)
+{
+	// block_size may be 0 for the default size
+
+	cc_arena_t* self;
+	self = (cc_arena_t*) CALLOC(1, sizeof(cc_arena_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	if(block_size == 0)
+	{
+		block_size = CC_ARENA_BLOCK_SIZE;
+	}
+	self->block_size = block_size;
+
+	return self;
+}
+
+void cc_arena_delete(cc_arena_t** _self)
+{
+	ASSERT(_self);
+
+	cc_arena_t* self = *_self;
+	if(self)
+	{
+		cc_arenaBlock_t* block = self->blocks;
+		while(block)
+		{
+			self->blocks = block->next;
+			FREE(block);
+			block = self->blocks;
+		}
+
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+void* cc_arena_alloc(cc_arena_t* self, size_t size)
+{
+	ASSERT(self);
+
+	// allocate from the current block
+	void* ptr;
+	cc_arenaBlock_t* next = self->blocks;
+	if(self->block)
+	{
+		ptr = cc_arenaBlock_alloc(self->block, &self->offset,
+		                          size);
+		if(ptr)
+		{
+			return ptr;
+		}
+
+		next = self->block->next;
+	}
+
+	// reuse the next block which was retained by a
+	// previous reset or rewind
+	size_t offset = 0;
+	if(next)
+	{
+		ptr = cc_arenaBlock_alloc(next, &offset, size);
+		if(ptr)
+		{
+			self->block  = next;
+			self->offset = offset;
+			return ptr;
+		}
+	}
+
+	// insert a new block after the current block
+	size_t block_size = self->block_size;
+	if(size + CC_ARENA_ALIGN > block_size)
+	{
+		block_size = size + CC_ARENA_ALIGN;
+	}
+
+	cc_arenaBlock_t* block = cc_arenaBlock_new(block_size);
+	if(block == NULL)
+	{
+		return NULL;
+	}
+
+	block->next = next;
+	if(self->block)
+	{
+		self->block->next = block;
+	}
+	else
+	{
+		self->blocks = block;
+	}
+
+	ptr = cc_arenaBlock_alloc(block, &offset, size);
+	self->block  = block;
+	self->offset = offset;
+
+	return ptr;
+}
+
+void* cc_arena_calloc(cc_arena_t* self,
+                      size_t count, size_t size)
+{
+	ASSERT(self);
+
+	void* ptr = cc_arena_alloc(self, count*size);
+	if(ptr)
+	{
+		memset(ptr, 0, count*size);
+	}
+
+	return ptr;
+}
+
+void cc_arena_mark(cc_arena_t* self, cc_arenaMark_t* mark)
+{
+	ASSERT(self);
+	ASSERT(mark);
+
+	mark->block  = self->block;
+	mark->offset = self->offset;
+}
+
+void cc_arena_rewind(cc_arena_t* self,
+                     const cc_arenaMark_t* mark)
+{
+	ASSERT(self);
+	ASSERT(mark);
+
+	// allocations made after the mark are released however
+	// the blocks are retained for reuse
+	self->block  = mark->block;
+	self->offset = mark->offset;
+}
+
+void cc_arena_reset(cc_arena_t* self)
+{
+	ASSERT(self);
+
+	self->block  = NULL;
+	self->offset = 0;
+}
+
+size_t cc_arena_sizeof(const cc_arena_t* self)
+{
+	ASSERT(self);
+
+	size_t size = sizeof(cc_arena_t);
+
+	cc_arenaBlock_t* block = self->blocks;
+	while(block)
+	{
+		size += sizeof(cc_arenaBlock_t) + block->size;
+		block = block->next;
+	}
+
+	return size;
+}
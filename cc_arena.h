@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_arena_H
+#define cc_arena_H
+
+#include <stddef.h>
+
+// The arena is a bump-pointer allocator for short-lived
+// data. Allocations cannot be freed individually. Instead
+// the arena may be rewound to a mark or reset which retains
+// the blocks for reuse. Blocks are allocated with MALLOC so
+// they are included in the MEMCOUNT/MEMSIZE totals.
+
+typedef struct cc_arenaBlock_s cc_arenaBlock_t;
+
+typedef struct
+{
+	cc_arenaBlock_t* block;
+	size_t           offset;
+} cc_arenaMark_t;
+
+typedef struct cc_arena_s
+{
+	size_t           block_size;
+	cc_arenaBlock_t* blocks;
+
+	// current block and offset
+	// block is NULL after reset
+	cc_arenaBlock_t* block;
+	size_t           offset;
+} cc_arena_t;
+
+cc_arena_t* cc_arena_new(size_t block_size);
+void        cc_arena_delete(cc_arena_t** _self);
+void*       cc_arena_alloc(cc_arena_t* self, size_t size);
+void*       cc_arena_calloc(cc_arena_t* self,
+                            size_t count, size_t size);
+void        cc_arena_mark(cc_arena_t* self,
+                          cc_arenaMark_t* mark);
+void        cc_arena_rewind(cc_arena_t* self,
+                            const cc_arenaMark_t* mark);
+void        cc_arena_reset(cc_arena_t* self);
+size_t      cc_arena_sizeof(const cc_arena_t* self);
+
+#endif
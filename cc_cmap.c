@@ -0,0 +1,643 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "cc"
+#include "cc_cmap.h"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_mumurhash3.h"
+
+#define CC_CMAP_BUCKETS 16
+
+// retired nodes are reclaimed in batches since reclaiming
+// must wait for the readers of the previous epoch
+#define CC_CMAP_RETIRE 64
+
+// readers are assigned to slots round-robin
+static atomic_uint       g_cmap_slots = 0;
+static _Thread_local int g_cmap_slot  = -1;
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static atomic_int* cc_cmap_readLock(cc_cmap_t* self)
+{
+	ASSERT(self);
+
+	if(g_cmap_slot < 0)
+	{
+		unsigned int slot = atomic_fetch_add(&g_cmap_slots, 1);
+		g_cmap_slot = (int) (slot % CC_CMAP_READERS);
+	}
+
+	cc_cmapReader_t* reader = &self->readers[g_cmap_slot];
+
+	// the epoch is checked again after the reader has been
+	// counted since the writer may have advanced the epoch
+	// and finished waiting on the previous count already
+	while(1)
+	{
+		unsigned int epoch = atomic_load(&self->epoch);
+		atomic_int*  count = &reader->count[epoch & 1];
+		atomic_fetch_add(count, 1);
+		if(atomic_load(&self->epoch) == epoch)
+		{
+			return count;
+		}
+		atomic_fetch_sub(count, 1);
+	}
+}
+
+static void cc_cmap_readUnlock(atomic_int* count)
+{
+	ASSERT(count);
+
+	atomic_fetch_sub(count, 1);
+}
+
+static const uint8_t*
+cc_cmap_hash(cc_cmap_t* self, int* _len,
+             const void* const* _key, uint32_t* _hash)
+{
+	ASSERT(self);
+	ASSERT(_len);
+	ASSERT(_key);
+	ASSERT(_hash);
+
+	int            len  = *_len;
+	const uint8_t* key8 = (const uint8_t*) *_key;
+	if(len == 0)
+	{
+		// pointer itself is the key
+		len  = sizeof(void*);
+		key8 = (const uint8_t*) _key;
+	}
+
+	*_len  = len;
+	*_hash = cc_mumurhash3(self->seed, len, key8);
+
+	return key8;
+}
+
+static inline _Atomic(cc_cmapNode_t*)*
+cc_cmapTable_buckets(cc_cmapTable_t* self)
+{
+	ASSERT(self);
+
+	return (_Atomic(cc_cmapNode_t*)*) &self[1];
+}
+
+static cc_cmapTable_t* cc_cmapTable_new(uint32_t count)
+{
+	size_t size = sizeof(cc_cmapTable_t) +
+	              count*sizeof(_Atomic(cc_cmapNode_t*));
+
+	cc_cmapTable_t* self;
+	self = (cc_cmapTable_t*) MALLOC_TAG(CC_MEMTAG_MAP, size);
+	if(self == NULL)
+	{
+		LOGE("MALLOC_TAG failed");
+		return NULL;
+	}
+
+	self->mask    = count - 1;
+	self->retired = NULL;
+
+	_Atomic(cc_cmapNode_t*)* buckets;
+	buckets = cc_cmapTable_buckets(self);
+
+	uint32_t i;
+	for(i = 0; i < count; ++i)
+	{
+		atomic_init(&buckets[i], NULL);
+	}
+
+	return self;
+}
+
+static inline const uint8_t*
+cc_cmapNode_key(cc_cmapNode_t* self)
+{
+	ASSERT(self);
+
+	return (const uint8_t*) &self[1];
+}
+
+static cc_cmapNode_t*
+cc_cmapNode_new(const void* val, uint32_t hash, int len,
+                const uint8_t* key)
+{
+	ASSERT(key);
+
+	size_t size = sizeof(cc_cmapNode_t) + len;
+
+	cc_cmapNode_t* self;
+	self = (cc_cmapNode_t*) MALLOC_TAG(CC_MEMTAG_MAP, size);
+	if(self == NULL)
+	{
+		LOGE("MALLOC_TAG failed");
+		return NULL;
+	}
+
+	atomic_init(&self->next, NULL);
+	self->retired = NULL;
+	self->val     = val;
+	self->hash    = hash;
+	self->len     = len;
+	memcpy((void*) &self[1], (const void*) key, len);
+
+	return self;
+}
+
+static int
+cc_cmapNode_cmp(cc_cmapNode_t* self, uint32_t hash,
+                int len, const uint8_t* key)
+{
+	ASSERT(self);
+	ASSERT(key);
+
+	if((self->hash != hash) || (self->len != len))
+	{
+		return 0;
+	}
+
+	return memcmp((const void*) cc_cmapNode_key(self),
+	              (const void*) key, len) == 0;
+}
+
+static void
+cc_cmap_retireNode(cc_cmap_t* self, cc_cmapNode_t* node)
+{
+	ASSERT(self);
+	ASSERT(node);
+
+	node->retired       = self->retired_nodes;
+	self->retired_nodes = node;
+	++self->retired_count;
+}
+
+static void
+cc_cmap_retireTable(cc_cmap_t* self, cc_cmapTable_t* table)
+{
+	ASSERT(self);
+	ASSERT(table);
+
+	table->retired       = self->retired_tables;
+	self->retired_tables = table;
+}
+
+static void cc_cmap_reclaim(cc_cmap_t* self)
+{
+	ASSERT(self);
+
+	// writer mutex must be locked
+
+	if((self->retired_nodes == NULL) &&
+	   (self->retired_tables == NULL))
+	{
+		return;
+	}
+
+	// readers which started after the epoch advances cannot
+	// reach the retired memory so wait for the readers of
+	// the previous epoch to finish
+	unsigned int epoch = atomic_fetch_add(&self->epoch, 1);
+
+	int i;
+	for(i = 0; i < CC_CMAP_READERS; ++i)
+	{
+		atomic_int* count;
+		count = &self->readers[i].count[epoch & 1];
+		while(atomic_load(count) > 0)
+		{
+			sched_yield();
+		}
+	}
+
+	while(self->retired_nodes)
+	{
+		cc_cmapNode_t* node = self->retired_nodes;
+		self->retired_nodes = node->retired;
+		FREE(node);
+	}
+
+	while(self->retired_tables)
+	{
+		cc_cmapTable_t* table = self->retired_tables;
+		self->retired_tables  = table->retired;
+		FREE(table);
+	}
+
+	self->retired_count = 0;
+}
+
+static void cc_cmap_grow(cc_cmap_t* self)
+{
+	ASSERT(self);
+
+	// writer mutex must be locked
+
+	cc_cmapTable_t* table1 = atomic_load(&self->table);
+
+	// maximum load factor of 1
+	uint32_t count1 = table1->mask + 1;
+	if((uint32_t) atomic_load(&self->size) < count1)
+	{
+		return;
+	}
+
+	uint32_t        count = 2*count1;
+	cc_cmapTable_t* table = cc_cmapTable_new(count);
+	if(table == NULL)
+	{
+		// continue with the current table
+		return;
+	}
+
+	// readers may be traversing the current buckets so the
+	// nodes are copied rather than relinked
+	_Atomic(cc_cmapNode_t*)* buckets1;
+	_Atomic(cc_cmapNode_t*)* buckets;
+	buckets1 = cc_cmapTable_buckets(table1);
+	buckets  = cc_cmapTable_buckets(table);
+
+	uint32_t       i;
+	uint32_t       idx;
+	cc_cmapNode_t* node;
+	cc_cmapNode_t* copy;
+	for(i = 0; i < count1; ++i)
+	{
+		node = atomic_load(&buckets1[i]);
+		while(node)
+		{
+			copy = cc_cmapNode_new(node->val, node->hash,
+			                       node->len,
+			                       cc_cmapNode_key(node));
+			if(copy == NULL)
+			{
+				goto fail_copy;
+			}
+
+			idx = copy->hash & table->mask;
+			atomic_init(&copy->next,
+			            atomic_load(&buckets[idx]));
+			atomic_init(&buckets[idx], copy);
+
+			node = atomic_load(&node->next);
+		}
+	}
+
+	atomic_store(&self->table, table);
+
+	// retire the current table
+	for(i = 0; i < count1; ++i)
+	{
+		node = atomic_load(&buckets1[i]);
+		while(node)
+		{
+			cc_cmap_retireNode(self, node);
+			node = atomic_load(&node->next);
+		}
+	}
+	cc_cmap_retireTable(self, table1);
+	cc_cmap_reclaim(self);
+
+	// success
+	return;
+
+	// failure
+	fail_copy:
+	{
+		for(i = 0; i < count; ++i)
+		{
+			node = atomic_load(&buckets[i]);
+			while(node)
+			{
+				copy = node;
+				node = atomic_load(&node->next);
+				FREE(copy);
+			}
+		}
+		FREE(table);
+	}
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_cmap_t* cc_cmap_new(void)
+{
+	cc_cmap_t* self;
+	self = (cc_cmap_t*)
+	       CALLOC_TAG(CC_MEMTAG_MAP, 1, sizeof(cc_cmap_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC_TAG failed");
+		return NULL;
+	}
+
+	self->seed = random();
+	atomic_init(&self->size, 0);
+	atomic_init(&self->epoch, 0);
+
+	size_t size = CC_CMAP_READERS*sizeof(cc_cmapReader_t);
+	self->readers = (cc_cmapReader_t*)
+	                MALLOC_ALIGNED(CC_CMAP_CACHELINE, size);
+	if(self->readers == NULL)
+	{
+		LOGE("MALLOC_ALIGNED failed");
+		goto fail_readers;
+	}
+
+	int i;
+	for(i = 0; i < CC_CMAP_READERS; ++i)
+	{
+		atomic_init(&self->readers[i].count[0], 0);
+		atomic_init(&self->readers[i].count[1], 0);
+	}
+
+	if(pthread_mutex_init(&self->mutex, NULL) != 0)
+	{
+		LOGE("pthread_mutex_init failed");
+		goto fail_mutex_init;
+	}
+
+	cc_cmapTable_t* table = cc_cmapTable_new(CC_CMAP_BUCKETS);
+	if(table == NULL)
+	{
+		goto fail_table;
+	}
+	atomic_init(&self->table, table);
+
+	// success
+	return self;
+
+	// failure
+	fail_table:
+		pthread_mutex_destroy(&self->mutex);
+	fail_mutex_init:
+		FREE_ALIGNED(self->readers);
+	fail_readers:
+		FREE(self);
+	return NULL;
+}
+
+void cc_cmap_delete(cc_cmap_t** _self)
+{
+	ASSERT(_self);
+
+	// readers must have finished
+
+	cc_cmap_t* self = *_self;
+	if(self)
+	{
+		cc_cmapTable_t* table = atomic_load(&self->table);
+
+		_Atomic(cc_cmapNode_t*)* buckets;
+		buckets = cc_cmapTable_buckets(table);
+
+		uint32_t       i;
+		cc_cmapNode_t* node;
+		for(i = 0; i <= table->mask; ++i)
+		{
+			node = atomic_load(&buckets[i]);
+			while(node)
+			{
+				cc_cmap_retireNode(self, node);
+				node = atomic_load(&node->next);
+			}
+		}
+		cc_cmap_retireTable(self, table);
+		cc_cmap_reclaim(self);
+
+		pthread_mutex_destroy(&self->mutex);
+		FREE_ALIGNED(self->readers);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int cc_cmap_size(cc_cmap_t* self)
+{
+	ASSERT(self);
+
+	return atomic_load(&self->size);
+}
+
+int cc_cmap_findp(cc_cmap_t* self, int len,
+                  const void* key, const void** _val)
+{
+	ASSERT(self);
+	ASSERT(key);
+	ASSERT(_val);
+
+	uint32_t       hash;
+	const uint8_t* key8;
+	key8 = cc_cmap_hash(self, &len, &key, &hash);
+
+	atomic_int* count = cc_cmap_readLock(self);
+
+	cc_cmapTable_t* table = atomic_load(&self->table);
+
+	_Atomic(cc_cmapNode_t*)* buckets;
+	buckets = cc_cmapTable_buckets(table);
+
+	int            found = 0;
+	cc_cmapNode_t* node;
+	node = atomic_load(&buckets[hash & table->mask]);
+	while(node)
+	{
+		if(cc_cmapNode_cmp(node, hash, len, key8))
+		{
+			*_val = node->val;
+			found = 1;
+			break;
+		}
+
+		node = atomic_load(&node->next);
+	}
+
+	cc_cmap_readUnlock(count);
+
+	return found;
+}
+
+int cc_cmap_find(cc_cmap_t* self, const char* key,
+                 const void** _val)
+{
+	ASSERT(self);
+	ASSERT(key);
+	ASSERT(_val);
+
+	int len = strlen(key) + 1;
+	return cc_cmap_findp(self, len, (const void*) key, _val);
+}
+
+int cc_cmap_addp(cc_cmap_t* self, const void* val,
+                 int len, const void* key)
+{
+	// val may be NULL
+	ASSERT(self);
+	ASSERT(key);
+
+	uint32_t       hash;
+	const uint8_t* key8;
+	key8 = cc_cmap_hash(self, &len, &key, &hash);
+
+	pthread_mutex_lock(&self->mutex);
+
+	cc_cmapTable_t* table = atomic_load(&self->table);
+
+	_Atomic(cc_cmapNode_t*)* bucket;
+	bucket = &cc_cmapTable_buckets(table)[hash & table->mask];
+
+	// check for duplicates
+	cc_cmapNode_t* node = atomic_load(bucket);
+	while(node)
+	{
+		if(cc_cmapNode_cmp(node, hash, len, key8))
+		{
+			goto fail_duplicate;
+		}
+
+		node = atomic_load(&node->next);
+	}
+
+	node = cc_cmapNode_new(val, hash, len, key8);
+	if(node == NULL)
+	{
+		goto fail_node;
+	}
+
+	// publish the initialized node to readers
+	atomic_init(&node->next, atomic_load(bucket));
+	atomic_store(bucket, node);
+	atomic_fetch_add(&self->size, 1);
+
+	cc_cmap_grow(self);
+
+	pthread_mutex_unlock(&self->mutex);
+
+	// success
+	return 1;
+
+	// failure
+	fail_node:
+	fail_duplicate:
+		pthread_mutex_unlock(&self->mutex);
+	return 0;
+}
+
+int cc_cmap_add(cc_cmap_t* self, const void* val,
+                const char* key)
+{
+	// val may be NULL
+	ASSERT(self);
+	ASSERT(key);
+
+	int len = strlen(key) + 1;
+	return cc_cmap_addp(self, val, len, (const void*) key);
+}
+
+int cc_cmap_removep(cc_cmap_t* self, int len,
+                    const void* key, const void** _val)
+{
+	// _val may be NULL
+	ASSERT(self);
+	ASSERT(key);
+
+	uint32_t       hash;
+	const uint8_t* key8;
+	key8 = cc_cmap_hash(self, &len, &key, &hash);
+
+	pthread_mutex_lock(&self->mutex);
+
+	cc_cmapTable_t* table = atomic_load(&self->table);
+
+	_Atomic(cc_cmapNode_t*)* link;
+	link = &cc_cmapTable_buckets(table)[hash & table->mask];
+
+	cc_cmapNode_t* node = atomic_load(link);
+	while(node)
+	{
+		if(cc_cmapNode_cmp(node, hash, len, key8))
+		{
+			break;
+		}
+
+		link = &node->next;
+		node = atomic_load(link);
+	}
+
+	if(node == NULL)
+	{
+		pthread_mutex_unlock(&self->mutex);
+		return 0;
+	}
+
+	if(_val)
+	{
+		*_val = node->val;
+	}
+
+	// readers on the node may continue to follow next until
+	// the node is reclaimed
+	atomic_store(link, atomic_load(&node->next));
+	atomic_fetch_sub(&self->size, 1);
+
+	cc_cmap_retireNode(self, node);
+	if(self->retired_count >= CC_CMAP_RETIRE)
+	{
+		cc_cmap_reclaim(self);
+	}
+
+	pthread_mutex_unlock(&self->mutex);
+
+	return 1;
+}
+
+int cc_cmap_remove(cc_cmap_t* self, const char* key,
+                   const void** _val)
+{
+	// _val may be NULL
+	ASSERT(self);
+	ASSERT(key);
+
+	int len = strlen(key) + 1;
+	return cc_cmap_removep(self, len, (const void*) key, _val);
+}
+
+void cc_cmap_synchronize(cc_cmap_t* self)
+{
+	ASSERT(self);
+
+	pthread_mutex_lock(&self->mutex);
+	cc_cmap_reclaim(self);
+	pthread_mutex_unlock(&self->mutex);
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_cmap_H
+#define cc_cmap_H
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+// The cmap is a concurrent hash map for read-mostly tables
+// which are shared between threads. Readers never take a
+// lock while writers are serialized by a mutex. Removed
+// entries and replaced bucket tables are retired and freed
+// once all readers which may still reference them have
+// finished (epoch based reclamation). Readers are counted
+// per epoch in CC_CMAP_READERS cache line sized slots that
+// are shared by threads round-robin to avoid contention.
+//
+// Find returns a copy of the value rather than an iterator
+// since entries may be removed concurrently. The caller is
+// responsible for the lifetime of the values.
+
+#define CC_CMAP_READERS   64
+#define CC_CMAP_CACHELINE 64
+
+typedef struct cc_cmapNode_s
+{
+	_Atomic(struct cc_cmapNode_s*) next;
+	struct cc_cmapNode_s*          retired;
+
+	const void* val;
+	uint32_t    hash;
+	int         len;
+
+	// key stored after node
+} cc_cmapNode_t;
+
+typedef struct cc_cmapTable_s
+{
+	uint32_t               mask;
+	struct cc_cmapTable_s* retired;
+
+	// buckets stored after table
+} cc_cmapTable_t;
+
+// readers are counted for the current and previous epoch
+typedef struct
+{
+	atomic_int count[2];
+	uint8_t    pad[CC_CMAP_CACHELINE - 2*sizeof(atomic_int)];
+} cc_cmapReader_t;
+
+typedef struct
+{
+	uint32_t   seed;
+	atomic_int size;
+
+	// readers and epoch
+	atomic_uint      epoch;
+	cc_cmapReader_t* readers;
+
+	// writer state
+	pthread_mutex_t mutex;
+	int             retired_count;
+	cc_cmapNode_t*  retired_nodes;
+	cc_cmapTable_t* retired_tables;
+
+	_Atomic(cc_cmapTable_t*) table;
+} cc_cmap_t;
+
+cc_cmap_t* cc_cmap_new(void);
+void       cc_cmap_delete(cc_cmap_t** _self);
+int        cc_cmap_size(cc_cmap_t* self);
+int        cc_cmap_findp(cc_cmap_t* self, int len,
+                         const void* key,
+                         const void** _val);
+int        cc_cmap_find(cc_cmap_t* self, const char* key,
+                        const void** _val);
+int        cc_cmap_addp(cc_cmap_t* self, const void* val,
+                        int len, const void* key);
+int        cc_cmap_add(cc_cmap_t* self, const void* val,
+                       const char* key);
+int        cc_cmap_removep(cc_cmap_t* self, int len,
+                           const void* key,
+                           const void** _val);
+int        cc_cmap_remove(cc_cmap_t* self, const char* key,
+                          const void** _val);
+void       cc_cmap_synchronize(cc_cmap_t* self);
+
+#endif
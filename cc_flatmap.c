@@ -0,0 +1,689 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+	#include <emmintrin.h>
+#endif
+
+#define LOG_TAG "cc"
+#include "cc_flatmap.h"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_mumurhash3.h"
+
+// stack buffer size for formatted keys
+// longer keys are formatted into a heap buffer
+#define CC_FLATMAP_KEYLEN 256
+
+#define CC_FLATMAP_CAPACITY 16
+
+// control tags
+// full slots store the low 7 bits of the hash
+#define CC_FLATMAP_EMPTY   ((int8_t) -128)
+#define CC_FLATMAP_DELETED ((int8_t) -2)
+
+#define CC_FLATMAP_H1(hash) ((hash) >> 7)
+#define CC_FLATMAP_H2(hash) ((int8_t) ((hash) & 0x7F))
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// returns a bitmask of the slots in the group whose tag
+// matches the requested tag
+static inline uint32_t
+cc_flatmap_match(const int8_t* ctrl, int8_t tag)
+{
+	ASSERT(ctrl);
+
+	#ifdef __SSE2__
+		__m128i group = _mm_loadu_si128((const __m128i*) ctrl);
+		__m128i match = _mm_cmpeq_epi8(group, _mm_set1_epi8(tag));
+		return (uint32_t) _mm_movemask_epi8(match);
+	#else
+		uint32_t mask = 0;
+
+		int i;
+		for(i = 0; i < CC_FLATMAP_GROUP_SIZE; ++i)
+		{
+			if(ctrl[i] == tag)
+			{
+				mask |= (1 << i);
+			}
+		}
+
+		return mask;
+	#endif
+}
+
+// returns a bitmask of the empty or deleted slots
+static inline uint32_t
+cc_flatmap_matchFree(const int8_t* ctrl)
+{
+	ASSERT(ctrl);
+
+	// empty and deleted tags are negative
+	#ifdef __SSE2__
+		__m128i group = _mm_loadu_si128((const __m128i*) ctrl);
+		return (uint32_t) _mm_movemask_epi8(group);
+	#else
+		uint32_t mask = 0;
+
+		int i;
+		for(i = 0; i < CC_FLATMAP_GROUP_SIZE; ++i)
+		{
+			if(ctrl[i] < 0)
+			{
+				mask |= (1 << i);
+			}
+		}
+
+		return mask;
+	#endif
+}
+
+static const uint8_t*
+cc_flatmapSlot_key(const cc_flatmapSlot_t* self)
+{
+	ASSERT(self);
+
+	if(self->len > CC_FLATMAP_INLINE)
+	{
+		return self->ptr;
+	}
+
+	return self->key;
+}
+
+static int
+cc_flatmapSlot_cmp(const cc_flatmapSlot_t* self,
+                   uint32_t hash, int len, const uint8_t* key)
+{
+	ASSERT(self);
+	ASSERT(key);
+
+	if((self->hash != hash) || (self->len != len))
+	{
+		return 0;
+	}
+
+	const uint8_t* skey = cc_flatmapSlot_key(self);
+	return memcmp((const void*) skey, (const void*) key,
+	              len) == 0;
+}
+
+static char*
+cc_flatmap_format(char* buf, int* _len, const char* fmt,
+                  va_list argptr)
+{
+	ASSERT(buf);
+	ASSERT(_len);
+	ASSERT(fmt);
+
+	va_list argptr2;
+	va_copy(argptr2, argptr);
+
+	// format short keys into the stack buffer
+	char* key = buf;
+	int   len = vsnprintf(buf, CC_FLATMAP_KEYLEN, fmt, argptr);
+	if(len < 0)
+	{
+		LOGE("invalid fmt=%s", fmt);
+		key = NULL;
+	}
+	else if(len >= CC_FLATMAP_KEYLEN)
+	{
+		key = (char*) MALLOC(len + 1);
+		if(key == NULL)
+		{
+			LOGE("MALLOC failed");
+		}
+		else
+		{
+			vsnprintf(key, len + 1, fmt, argptr2);
+		}
+	}
+	va_end(argptr2);
+
+	*_len = len + 1;
+
+	return key;
+}
+
+static void cc_flatmap_formatFree(char* buf, char* key)
+{
+	ASSERT(buf);
+
+	if((key == NULL) || (key == buf))
+	{
+		return;
+	}
+
+	FREE(key);
+}
+
+static const uint8_t*
+cc_flatmap_hash(const cc_flatmap_t* self, int* _len,
+                const void* const* _key, uint32_t* _hash)
+{
+	ASSERT(self);
+	ASSERT(_len);
+	ASSERT(_key);
+	ASSERT(_hash);
+
+	int            len  = *_len;
+	const uint8_t* key8 = (const uint8_t*) *_key;
+	if(len == 0)
+	{
+		// pointer itself is the key
+		len  = sizeof(void*);
+		key8 = (const uint8_t*) _key;
+	}
+
+	*_len  = len;
+	*_hash = cc_mumurhash3(self->seed, len, key8);
+
+	return key8;
+}
+
+static cc_flatmapSlot_t*
+cc_flatmap_lookup(const cc_flatmap_t* self, uint32_t hash,
+                  int len, const uint8_t* key)
+{
+	ASSERT(self);
+	ASSERT(key);
+
+	int8_t   h2     = CC_FLATMAP_H2(hash);
+	uint32_t groups = self->capacity/CC_FLATMAP_GROUP_SIZE;
+	uint32_t mask   = groups - 1;
+	uint32_t g      = CC_FLATMAP_H1(hash) & mask;
+
+	// quadratic probe over the groups which visits every
+	// group since the group count is a power of two
+	uint32_t step;
+	for(step = 1; step <= groups; ++step)
+	{
+		int      base = g*CC_FLATMAP_GROUP_SIZE;
+		uint32_t bits = cc_flatmap_match(&self->ctrl[base], h2);
+		while(bits)
+		{
+			int i = base + __builtin_ctz(bits);
+			if(cc_flatmapSlot_cmp(&self->slots[i], hash,
+			                      len, key))
+			{
+				return &self->slots[i];
+			}
+			bits &= bits - 1;
+		}
+
+		// the key would have been placed in this group
+		if(cc_flatmap_match(&self->ctrl[base],
+		                    CC_FLATMAP_EMPTY))
+		{
+			return NULL;
+		}
+
+		g = (g + step) & mask;
+	}
+
+	return NULL;
+}
+
+static int
+cc_flatmap_slot(const cc_flatmap_t* self, uint32_t hash)
+{
+	ASSERT(self);
+
+	uint32_t groups = self->capacity/CC_FLATMAP_GROUP_SIZE;
+	uint32_t mask   = groups - 1;
+	uint32_t g      = CC_FLATMAP_H1(hash) & mask;
+
+	// find the first empty or deleted slot
+	uint32_t step;
+	for(step = 1; step <= groups; ++step)
+	{
+		int      base = g*CC_FLATMAP_GROUP_SIZE;
+		uint32_t bits = cc_flatmap_matchFree(&self->ctrl[base]);
+		if(bits)
+		{
+			return base + __builtin_ctz(bits);
+		}
+
+		g = (g + step) & mask;
+	}
+
+	// the load factor ensures a free slot exists
+	ASSERT(0);
+	return -1;
+}
+
+static int
+cc_flatmap_resize(cc_flatmap_t* self, int capacity)
+{
+	ASSERT(self);
+	ASSERT(capacity >= CC_FLATMAP_CAPACITY);
+
+	size_t size = capacity*(sizeof(cc_flatmapSlot_t) + 1);
+
+	cc_flatmapSlot_t* slots;
+	slots = (cc_flatmapSlot_t*)
+	        MALLOC_TAG(CC_MEMTAG_MAP, size);
+	if(slots == NULL)
+	{
+		LOGE("MALLOC_TAG failed");
+		return 0;
+	}
+
+	int8_t* ctrl = (int8_t*) &slots[capacity];
+	memset((void*) ctrl, CC_FLATMAP_EMPTY, capacity);
+
+	cc_flatmapSlot_t* slots1    = self->slots;
+	int8_t*           ctrl1     = self->ctrl;
+	int               capacity1 = self->capacity;
+
+	self->slots    = slots;
+	self->ctrl     = ctrl;
+	self->capacity = capacity;
+	self->deleted  = 0;
+
+	// reinsert the full slots
+	int i;
+	int j;
+	for(i = 0; i < capacity1; ++i)
+	{
+		if(ctrl1[i] < 0)
+		{
+			continue;
+		}
+
+		j = cc_flatmap_slot(self, slots1[i].hash);
+		ctrl[j]  = ctrl1[i];
+		slots[j] = slots1[i];
+	}
+
+	FREE(slots1);
+
+	return 1;
+}
+
+static int cc_flatmap_grow(cc_flatmap_t* self)
+{
+	ASSERT(self);
+
+	// maximum load factor of 7/8
+	int count = self->size + self->deleted + 1;
+	if(count <= self->capacity - self->capacity/8)
+	{
+		return 1;
+	}
+
+	// rehash in place to drop deleted slots unless the
+	// map is more than half full
+	int capacity = self->capacity;
+	if(self->size + 1 > capacity/2)
+	{
+		capacity *= 2;
+	}
+
+	return cc_flatmap_resize(self, capacity);
+}
+
+static cc_flatmapIter_t*
+cc_flatmap_scan(const cc_flatmap_t* self, int idx)
+{
+	ASSERT(self);
+
+	// find the next full slot
+	while(idx < self->capacity)
+	{
+		if(self->ctrl[idx] >= 0)
+		{
+			return &self->slots[idx];
+		}
+		++idx;
+	}
+
+	return NULL;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_flatmap_t* cc_flatmap_new(void)
+{
+	cc_flatmap_t* self;
+	self = (cc_flatmap_t*)
+	       CALLOC_TAG(CC_MEMTAG_MAP, 1, sizeof(cc_flatmap_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC_TAG failed");
+		return NULL;
+	}
+
+	self->seed = random();
+
+	if(cc_flatmap_resize(self, CC_FLATMAP_CAPACITY) == 0)
+	{
+		goto fail_resize;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_resize:
+		FREE(self);
+	return NULL;
+}
+
+void cc_flatmap_delete(cc_flatmap_t** _self)
+{
+	ASSERT(_self);
+
+	cc_flatmap_t* self = *_self;
+	if(self)
+	{
+		cc_flatmap_discard(self);
+		FREE(self->slots);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+void cc_flatmap_discard(cc_flatmap_t* self)
+{
+	ASSERT(self);
+
+	int i;
+	for(i = 0; i < self->capacity; ++i)
+	{
+		if((self->ctrl[i] >= 0) &&
+		   (self->slots[i].len > CC_FLATMAP_INLINE))
+		{
+			FREE(self->slots[i].ptr);
+		}
+	}
+
+	memset((void*) self->ctrl, CC_FLATMAP_EMPTY,
+	       self->capacity);
+	self->size      = 0;
+	self->deleted   = 0;
+	self->keys_size = 0;
+}
+
+int cc_flatmap_size(const cc_flatmap_t* self)
+{
+	ASSERT(self);
+
+	return self->size;
+}
+
+size_t cc_flatmap_sizeof(const cc_flatmap_t* self)
+{
+	ASSERT(self);
+
+	// sizeof map + slots + ctrl + keys
+	size_t size = sizeof(cc_flatmap_t);
+	size += self->capacity*(sizeof(cc_flatmapSlot_t) + 1);
+	size += self->keys_size;
+	return size;
+}
+
+cc_flatmapIter_t*
+cc_flatmap_head(const cc_flatmap_t* self)
+{
+	ASSERT(self);
+
+	return cc_flatmap_scan(self, 0);
+}
+
+cc_flatmapIter_t*
+cc_flatmap_next(const cc_flatmap_t* self,
+                cc_flatmapIter_t* miter)
+{
+	ASSERT(self);
+	ASSERT(miter);
+
+	return cc_flatmap_scan(self, miter - self->slots + 1);
+}
+
+const void*
+cc_flatmap_key(const cc_flatmapIter_t* miter, int* _len)
+{
+	ASSERT(miter);
+	ASSERT(_len);
+
+	*_len = miter->len;
+
+	return (const void*) cc_flatmapSlot_key(miter);
+}
+
+const void* cc_flatmap_val(const cc_flatmapIter_t* miter)
+{
+	ASSERT(miter);
+
+	return miter->val;
+}
+
+cc_flatmapIter_t*
+cc_flatmap_findp(const cc_flatmap_t* self, int len,
+                 const void* key)
+{
+	ASSERT(self);
+	ASSERT(key);
+
+	uint32_t       hash;
+	const uint8_t* key8;
+	key8 = cc_flatmap_hash(self, &len, &key, &hash);
+
+	return cc_flatmap_lookup(self, hash, len, key8);
+}
+
+cc_flatmapIter_t*
+cc_flatmap_find(const cc_flatmap_t* self, const char* key)
+{
+	ASSERT(self);
+	ASSERT(key);
+
+	int len = strlen(key) + 1;
+	return cc_flatmap_findp(self, len, (const void*) key);
+}
+
+cc_flatmapIter_t*
+cc_flatmap_findf(const cc_flatmap_t* self,
+                 const char* fmt, ...)
+{
+	ASSERT(self);
+	ASSERT(fmt);
+
+	int     len;
+	char    buf[CC_FLATMAP_KEYLEN];
+	char*   key;
+	va_list argptr;
+	va_start(argptr, fmt);
+	key = cc_flatmap_format(buf, &len, fmt, argptr);
+	va_end(argptr);
+
+	if(key == NULL)
+	{
+		return NULL;
+	}
+
+	cc_flatmapIter_t* miter;
+	miter = cc_flatmap_findp(self, len, (const void*) key);
+	cc_flatmap_formatFree(buf, key);
+
+	return miter;
+}
+
+cc_flatmapIter_t*
+cc_flatmap_addp(cc_flatmap_t* self, const void* val,
+                int len, const void* key)
+{
+	// val may be NULL
+	ASSERT(self);
+	ASSERT(key);
+
+	uint32_t       hash;
+	const uint8_t* key8;
+	key8 = cc_flatmap_hash(self, &len, &key, &hash);
+	if(cc_flatmap_lookup(self, hash, len, key8))
+	{
+		return NULL;
+	}
+
+	// copy long keys before the map is modified
+	uint8_t* ptr = NULL;
+	if(len > CC_FLATMAP_INLINE)
+	{
+		ptr = (uint8_t*) MALLOC_TAG(CC_MEMTAG_MAP, len);
+		if(ptr == NULL)
+		{
+			LOGE("MALLOC_TAG failed");
+			return NULL;
+		}
+		memcpy((void*) ptr, (const void*) key8, len);
+	}
+
+	if(cc_flatmap_grow(self) == 0)
+	{
+		goto fail_grow;
+	}
+
+	int idx = cc_flatmap_slot(self, hash);
+	if(self->ctrl[idx] == CC_FLATMAP_DELETED)
+	{
+		--self->deleted;
+	}
+	self->ctrl[idx] = CC_FLATMAP_H2(hash);
+
+	cc_flatmapSlot_t* slot = &self->slots[idx];
+	slot->val  = val;
+	slot->hash = hash;
+	slot->len  = len;
+	if(ptr)
+	{
+		slot->ptr        = ptr;
+		self->keys_size += len;
+	}
+	else
+	{
+		memcpy((void*) slot->key, (const void*) key8, len);
+	}
+	++self->size;
+
+	// success
+	return slot;
+
+	// failure
+	fail_grow:
+		FREE(ptr);
+	return NULL;
+}
+
+cc_flatmapIter_t*
+cc_flatmap_add(cc_flatmap_t* self, const void* val,
+               const char* key)
+{
+	// val may be NULL
+	ASSERT(self);
+	ASSERT(key);
+
+	int len = strlen(key) + 1;
+	return cc_flatmap_addp(self, val, len, (const void*) key);
+}
+
+cc_flatmapIter_t*
+cc_flatmap_addf(cc_flatmap_t* self, const void* val,
+                const char* fmt, ...)
+{
+	// val may be NULL
+	ASSERT(self);
+	ASSERT(fmt);
+
+	int     len;
+	char    buf[CC_FLATMAP_KEYLEN];
+	char*   key;
+	va_list argptr;
+	va_start(argptr, fmt);
+	key = cc_flatmap_format(buf, &len, fmt, argptr);
+	va_end(argptr);
+
+	if(key == NULL)
+	{
+		return NULL;
+	}
+
+	cc_flatmapIter_t* miter;
+	miter = cc_flatmap_addp(self, val, len, (const void*) key);
+	cc_flatmap_formatFree(buf, key);
+
+	return miter;
+}
+
+const void*
+cc_flatmap_remove(cc_flatmap_t* self,
+                  cc_flatmapIter_t** _miter)
+{
+	ASSERT(self);
+	ASSERT(_miter);
+	ASSERT(*_miter);
+
+	cc_flatmapIter_t* miter = *_miter;
+	const void*       val   = miter->val;
+
+	int idx = miter - self->slots;
+	ASSERT(self->ctrl[idx] >= 0);
+
+	if(miter->len > CC_FLATMAP_INLINE)
+	{
+		self->keys_size -= miter->len;
+		FREE(miter->ptr);
+	}
+
+	// a probe sequence never continues past a group which
+	// contains an empty slot so the slot may be emptied
+	// rather than marked as deleted in that case
+	int base = idx - (idx % CC_FLATMAP_GROUP_SIZE);
+	if(cc_flatmap_match(&self->ctrl[base], CC_FLATMAP_EMPTY))
+	{
+		self->ctrl[idx] = CC_FLATMAP_EMPTY;
+	}
+	else
+	{
+		self->ctrl[idx] = CC_FLATMAP_DELETED;
+		++self->deleted;
+	}
+	--self->size;
+
+	// update miter
+	*_miter = cc_flatmap_scan(self, idx + 1);
+
+	return val;
+}
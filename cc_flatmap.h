@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_flatmap_H
+#define cc_flatmap_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+// The flatmap is an open addressing hash map which stores
+// its entries in a flat slot array with a one byte control
+// tag per slot. Lookups probe groups of
+// CC_FLATMAP_GROUP_SIZE tags at a time (using SSE2 when
+// available) and keys of up to CC_FLATMAP_INLINE bytes are
+// stored inline in the slot. Adding an entry may rehash the
+// slot array which invalidates all iterators while removing
+// an entry does not move the remaining entries.
+
+#define CC_FLATMAP_GROUP_SIZE 16
+#define CC_FLATMAP_INLINE     16
+
+typedef struct
+{
+	const void* val;
+	uint32_t    hash;
+	int         len;
+	union
+	{
+		uint8_t  key[CC_FLATMAP_INLINE];
+		uint8_t* ptr;
+	};
+} cc_flatmapSlot_t;
+
+typedef cc_flatmapSlot_t cc_flatmapIter_t;
+
+typedef struct
+{
+	uint32_t seed;
+	int      size;
+	int      deleted;
+	int      capacity;
+	size_t   keys_size;
+
+	// slots and ctrl share one allocation
+	cc_flatmapSlot_t* slots;
+	int8_t*           ctrl;
+} cc_flatmap_t;
+
+cc_flatmap_t*     cc_flatmap_new(void);
+void              cc_flatmap_delete(cc_flatmap_t** _self);
+void              cc_flatmap_discard(cc_flatmap_t* self);
+int               cc_flatmap_size(const cc_flatmap_t* self);
+size_t            cc_flatmap_sizeof(const cc_flatmap_t* self);
+cc_flatmapIter_t* cc_flatmap_head(const cc_flatmap_t* self);
+cc_flatmapIter_t* cc_flatmap_next(const cc_flatmap_t* self,
+                                  cc_flatmapIter_t* miter);
+const void*       cc_flatmap_key(const cc_flatmapIter_t* miter,
+                                 int* _len);
+const void*       cc_flatmap_val(const cc_flatmapIter_t* miter);
+cc_flatmapIter_t* cc_flatmap_findp(const cc_flatmap_t* self,
+                                   int len,
+                                   const void* key);
+cc_flatmapIter_t* cc_flatmap_find(const cc_flatmap_t* self,
+                                  const char* key);
+cc_flatmapIter_t* cc_flatmap_findf(const cc_flatmap_t* self,
+                                   const char* fmt, ...);
+cc_flatmapIter_t* cc_flatmap_addp(cc_flatmap_t* self,
+                                  const void* val,
+                                  int len,
+                                  const void* key);
+cc_flatmapIter_t* cc_flatmap_add(cc_flatmap_t* self,
+                                 const void* val,
+                                 const char* key);
+cc_flatmapIter_t* cc_flatmap_addf(cc_flatmap_t* self,
+                                  const void* val,
+                                  const char* fmt, ...);
+const void*       cc_flatmap_remove(cc_flatmap_t* self,
+                                    cc_flatmapIter_t** _miter);
+
+#endif
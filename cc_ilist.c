@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+
+#define LOG_TAG "cc"
+#include "cc_ilist.h"
+#include "cc_log.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static void
+cc_ilist_add(cc_ilist_t* self, cc_ilistLink_t* link,
+             cc_ilistLink_t* prev, cc_ilistLink_t* next)
+{
+	// prev and next can be NULL
+	ASSERT(self);
+	ASSERT(link);
+
+	link->next = next;
+	link->prev = prev;
+
+	// update next/prev links
+	if(next)
+	{
+		next->prev = link;
+	}
+	else
+	{
+		self->tail = link;
+	}
+
+	if(prev)
+	{
+		prev->next = link;
+	}
+	else
+	{
+		self->head = link;
+	}
+
+	++self->size;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+void cc_ilist_init(cc_ilist_t* self)
+{
+	ASSERT(self);
+
+	self->size = 0;
+	self->head = NULL;
+	self->tail = NULL;
+}
+
+int cc_ilist_size(const cc_ilist_t* self)
+{
+	ASSERT(self);
+
+	return self->size;
+}
+
+cc_ilistLink_t* cc_ilist_head(const cc_ilist_t* self)
+{
+	ASSERT(self);
+
+	return self->head;
+}
+
+cc_ilistLink_t* cc_ilist_tail(const cc_ilist_t* self)
+{
+	ASSERT(self);
+
+	return self->tail;
+}
+
+cc_ilistLink_t* cc_ilist_next(cc_ilistLink_t* link)
+{
+	ASSERT(link);
+
+	return link->next;
+}
+
+cc_ilistLink_t* cc_ilist_prev(cc_ilistLink_t* link)
+{
+	ASSERT(link);
+
+	return link->prev;
+}
+
+void cc_ilist_insert(cc_ilist_t* self, cc_ilistLink_t* pos,
+                     cc_ilistLink_t* link)
+{
+	// pos may be NULL to insert at head
+	ASSERT(self);
+	ASSERT(link);
+
+	if(pos)
+	{
+		cc_ilist_add(self, link, pos->prev, pos);
+	}
+	else
+	{
+		cc_ilist_add(self, link, NULL, self->head);
+	}
+}
+
+void cc_ilist_append(cc_ilist_t* self, cc_ilistLink_t* pos,
+                     cc_ilistLink_t* link)
+{
+	// pos may be NULL to append at tail
+	ASSERT(self);
+	ASSERT(link);
+
+	if(pos)
+	{
+		cc_ilist_add(self, link, pos, pos->next);
+	}
+	else
+	{
+		cc_ilist_add(self, link, self->tail, NULL);
+	}
+}
+
+void cc_ilist_remove(cc_ilist_t* self, cc_ilistLink_t* link)
+{
+	ASSERT(self);
+	ASSERT(link);
+
+	// update next/prev links
+	if(link->prev)
+	{
+		link->prev->next = link->next;
+	}
+	else
+	{
+		self->head = link->next;
+	}
+
+	if(link->next)
+	{
+		link->next->prev = link->prev;
+	}
+	else
+	{
+		self->tail = link->prev;
+	}
+
+	--self->size;
+
+	link->next = NULL;
+	link->prev = NULL;
+}
+
+void cc_ilist_move(cc_ilist_t* self, cc_ilistLink_t* from,
+                   cc_ilistLink_t* to)
+{
+	// to may be NULL to move to head
+	ASSERT(self);
+	ASSERT(from);
+
+	if(to == NULL)
+	{
+		to = self->head;
+	}
+
+	if((from == to) || (from == to->prev))
+	{
+		return;
+	}
+
+	// move from before to
+	cc_ilist_remove(self, from);
+	cc_ilist_add(self, from, to->prev, to);
+}
+
+void cc_ilist_moven(cc_ilist_t* self, cc_ilistLink_t* from,
+                    cc_ilistLink_t* to)
+{
+	// to may be NULL to move to tail
+	ASSERT(self);
+	ASSERT(from);
+
+	if(to == NULL)
+	{
+		to = self->tail;
+	}
+
+	if((from == to) || (from == to->next))
+	{
+		return;
+	}
+
+	// move from after to
+	cc_ilist_remove(self, from);
+	cc_ilist_add(self, from, to, to->next);
+}
+
+void cc_ilist_swap(cc_ilist_t* fromList, cc_ilist_t* toList,
+                   cc_ilistLink_t* from, cc_ilistLink_t* to)
+{
+	// to may be NULL to swap to head
+	ASSERT(fromList);
+	ASSERT(toList);
+	ASSERT(from);
+
+	if(fromList == toList)
+	{
+		cc_ilist_move(fromList, from, to);
+		return;
+	}
+
+	cc_ilist_remove(fromList, from);
+	cc_ilist_insert(toList, to, from);
+}
+
+void cc_ilist_swapn(cc_ilist_t* fromList, cc_ilist_t* toList,
+                    cc_ilistLink_t* from, cc_ilistLink_t* to)
+{
+	// to may be NULL to swap to tail
+	ASSERT(fromList);
+	ASSERT(toList);
+	ASSERT(from);
+
+	if(fromList == toList)
+	{
+		cc_ilist_moven(fromList, from, to);
+		return;
+	}
+
+	cc_ilist_remove(fromList, from);
+	cc_ilist_append(toList, to, from);
+}
+
+void cc_ilist_appendList(cc_ilist_t* self, cc_ilist_t* from)
+{
+	ASSERT(self);
+	ASSERT(from);
+
+	if(from->size == 0)
+	{
+		return;
+	}
+	else if(self->size == 0)
+	{
+		*self = *from;
+		cc_ilist_init(from);
+		return;
+	}
+
+	self->tail->next = from->head;
+	from->head->prev = self->tail;
+	self->tail  = from->tail;
+	self->size += from->size;
+	cc_ilist_init(from);
+}
+
+void cc_ilist_insertList(cc_ilist_t* self, cc_ilist_t* from)
+{
+	ASSERT(self);
+	ASSERT(from);
+
+	if(from->size == 0)
+	{
+		return;
+	}
+	else if(self->size == 0)
+	{
+		*self = *from;
+		cc_ilist_init(from);
+		return;
+	}
+
+	self->head->prev = from->tail;
+	from->tail->next = self->head;
+	self->head  = from->head;
+	self->size += from->size;
+	cc_ilist_init(from);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_ilist_H
+#define cc_ilist_H
+
+#include <stddef.h>
+
+// The intrusive list links objects which embed a
+// cc_ilistLink_t so that no iter is allocated per element.
+// The list does not own the objects and a link may only be
+// in one list at a time. Use CC_ILIST_ENTRY to get the
+// object which contains a link.
+
+#define CC_ILIST_ENTRY(link, type, member) \
+	((type*) (((char*) (link)) - offsetof(type, member)))
+
+typedef struct cc_ilistLink_s
+{
+	struct cc_ilistLink_s* next;
+	struct cc_ilistLink_s* prev;
+} cc_ilistLink_t;
+
+typedef struct
+{
+	int             size;
+	cc_ilistLink_t* head;
+	cc_ilistLink_t* tail;
+} cc_ilist_t;
+
+void            cc_ilist_init(cc_ilist_t* self);
+int             cc_ilist_size(const cc_ilist_t* self);
+cc_ilistLink_t* cc_ilist_head(const cc_ilist_t* self);
+cc_ilistLink_t* cc_ilist_tail(const cc_ilist_t* self);
+cc_ilistLink_t* cc_ilist_next(cc_ilistLink_t* link);
+cc_ilistLink_t* cc_ilist_prev(cc_ilistLink_t* link);
+void            cc_ilist_insert(cc_ilist_t* self,
+                                cc_ilistLink_t* pos,
+                                cc_ilistLink_t* link);
+void            cc_ilist_append(cc_ilist_t* self,
+                                cc_ilistLink_t* pos,
+                                cc_ilistLink_t* link);
+void            cc_ilist_remove(cc_ilist_t* self,
+                                cc_ilistLink_t* link);
+void            cc_ilist_move(cc_ilist_t* self,
+                              cc_ilistLink_t* from,
+                              cc_ilistLink_t* to);
+void            cc_ilist_moven(cc_ilist_t* self,
+                               cc_ilistLink_t* from,
+                               cc_ilistLink_t* to);
+void            cc_ilist_swap(cc_ilist_t* fromList,
+                              cc_ilist_t* toList,
+                              cc_ilistLink_t* from,
+                              cc_ilistLink_t* to);
+void            cc_ilist_swapn(cc_ilist_t* fromList,
+                               cc_ilist_t* toList,
+                               cc_ilistLink_t* from,
+                               cc_ilistLink_t* to);
+void            cc_ilist_appendList(cc_ilist_t* self,
+                                    cc_ilist_t* from);
+void            cc_ilist_insertList(cc_ilist_t* self,
+                                    cc_ilist_t* from);
+
+#endif
@@ -22,6 +22,7 @@
  */
 
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -31,6 +32,10 @@
 #include "cc_memory.h"
 
 #define CC_LIST_FLAG_CMALLOC 1
+#define CC_LIST_FLAG_ARENA   2
+
+// number of runs for cc_list_sort (e.g. 2^64 iters)
+#define CC_LIST_SORT_BINS 64
 
 /***********************************************************
 * protected - global listIter pool                         *
@@ -38,6 +43,13 @@
 
 #define CC_LISTBLOCK_SIZE 1024
 #define CC_LISTSET_SIZE   32
+#define CC_LISTCACHE_SIZE 256
+
+// the global pool is trimmed automatically once the number
+// of free iters exceeds the number of iters in use and the
+// free iters have grown by CC_LISTTRIM_BLOCKS since the
+// last trim
+#define CC_LISTTRIM_BLOCKS 4
 
 typedef struct cc_listBlock_s cc_listBlock_t;
 
@@ -49,13 +61,32 @@ typedef struct cc_listBlock_s
 
 typedef struct
 {
-	size_t          refcount;
+	// iters not in the global pool (e.g. held by lists or
+	// thread caches) which is only modified under the mutex
+	atomic_size_t   refcount;
 	size_t          count;
+	size_t          count_trim;
 	cc_listIter_t*  iters; // sll of free iter references
+	int             block_count;
 	cc_listBlock_t* blocks;
 	pthread_mutex_t mutex;
 } cc_listPool_t;
 
+// Each thread caches up to CC_LISTCACHE_SIZE free iters so
+// that lists which are created and deleted on the same
+// thread do not need to lock the global pool. Iters are
+// transferred to/from the global pool in batches.
+typedef struct
+{
+	size_t         count;
+	cc_listIter_t* iters;
+} cc_listCache_t;
+
+static pthread_once_t g_list_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  g_list_key;
+
+static _Thread_local cc_listCache_t* g_list_cache = NULL;
+
 // Android does not allow the use of
 // PTHREAD_MUTEX_INITIALIZER due to the Android app life
 // cycle as the mutex is not reinitialized after
@@ -92,19 +123,24 @@ static cc_listPool_t g_list_pool =
 * private - global listIter pool                           *
 ***********************************************************/
 
-static cc_listIter_t* cc_listPool_get(void)
+static cc_listIter_t* cc_listPool_getGlobal(size_t sets)
 {
+	ASSERT(sets > 0);
+
 	cc_listPool_t* pool = &g_list_pool;
 
+	size_t count = sets*CC_LISTSET_SIZE;
+
 	pthread_mutex_lock(&pool->mutex);
 
 	// check if free iters exist
-	if(pool->count < CC_LISTSET_SIZE)
+	while(pool->count < count)
 	{
 		// create a new block
 		cc_listBlock_t* block;
 		block = (cc_listBlock_t*)
-		        CALLOC(1, sizeof(cc_listBlock_t));
+		        CALLOC_TAG(CC_MEMTAG_LIST, 1,
+		                   sizeof(cc_listBlock_t));
 		if(block == NULL)
 		{
 			// silently fail
@@ -115,6 +151,7 @@ static cc_listIter_t* cc_listPool_get(void)
 		// insert block to list
 		block->next  = pool->blocks;
 		pool->blocks = block;
+		++pool->block_count;
 
 		// insert iter to list of free iters
 		int i;
@@ -129,46 +166,220 @@ static cc_listIter_t* cc_listPool_get(void)
 		pool->count += CC_LISTBLOCK_SIZE;
 	}
 
-	// get a set of free iters
-	int i;
+	// get the sets of free iters
+	size_t i;
 	cc_listIter_t* iters = pool->iters;
-	cc_listIter_t* tail;
-	for(i = 0; i < CC_LISTSET_SIZE; ++i)
+	cc_listIter_t* tail  = NULL;
+	for(i = 0; i < count; ++i)
 	{
 		tail        = pool->iters;
 		pool->iters = pool->iters->next;
 	}
 	tail->next = NULL;
 
-	pool->count    -= CC_LISTSET_SIZE;
-	pool->refcount += CC_LISTSET_SIZE;
+	pool->count -= count;
+	if(pool->count < pool->count_trim)
+	{
+		pool->count_trim = pool->count;
+	}
+	atomic_fetch_add(&pool->refcount, count);
 
 	pthread_mutex_unlock(&pool->mutex);
 
 	return iters;
 }
 
-static void cc_listPool_put(cc_listIter_t* iters)
+static int cc_listBlock_cmp(const void* a, const void* b)
 {
-	// iters may be NULL
+	ASSERT(a);
+	ASSERT(b);
+
+	const cc_listBlock_t* aa = *((const cc_listBlock_t**) a);
+	const cc_listBlock_t* bb = *((const cc_listBlock_t**) b);
+	if(aa < bb)
+	{
+		return -1;
+	}
+	else if(aa > bb)
+	{
+		return 1;
+	}
+	return 0;
+}
+
+static int
+cc_listBlock_find(cc_listBlock_t** blocks, int count,
+                  cc_listIter_t* iter)
+{
+	ASSERT(blocks);
+	ASSERT(iter);
 
+	// binary search the sorted blocks for the iter
+	int a = 0;
+	int b = count - 1;
+	while(a <= b)
+	{
+		int             m     = a + (b - a)/2;
+		cc_listBlock_t* block = blocks[m];
+		if(iter < &block->array[0])
+		{
+			b = m - 1;
+		}
+		else if(iter >= &block->array[CC_LISTBLOCK_SIZE])
+		{
+			a = m + 1;
+		}
+		else
+		{
+			return m;
+		}
+	}
+
+	// iters are always allocated from blocks
+	ASSERT(0);
+	return -1;
+}
+
+static void
+cc_listPool_trimLocked(cc_listPool_t* pool, int capacity,
+                       cc_listBlock_t** blocks, int* used)
+{
+	ASSERT(pool);
+	ASSERT(blocks);
+	ASSERT(used);
+
+	// blocks may have been added since the scratch arrays
+	// were allocated in which case the trim is skipped
+	int count = pool->block_count;
+	if((pool->count < CC_LISTBLOCK_SIZE) || (count > capacity))
+	{
+		return;
+	}
+
+	int             i     = 0;
+	cc_listBlock_t* block = pool->blocks;
+	while(block)
+	{
+		blocks[i]   = block;
+		used[i]     = 0;
+		block = block->next;
+		++i;
+	}
+	qsort((void*) blocks, count, sizeof(cc_listBlock_t*),
+	      cc_listBlock_cmp);
+
+	// the occupancy is computed from the free iters since
+	// iters do not reference their block
+	int            idx;
+	cc_listIter_t* iter = pool->iters;
+	while(iter)
+	{
+		idx = cc_listBlock_find(blocks, count, iter);
+		if(idx < 0)
+		{
+			LOGE("invalid iter=%p", iter);
+			return;
+		}
+		++used[idx];
+		iter = iter->next;
+	}
+
+	// check for free blocks where used counts free iters
+	int release = 0;
+	for(i = 0; i < count; ++i)
+	{
+		if(used[i] == CC_LISTBLOCK_SIZE)
+		{
+			++release;
+		}
+	}
+
+	if(release)
+	{
+		// remove iters of free blocks from free iters
+		cc_listIter_t* iters = NULL;
+		iter = pool->iters;
+		while(iter)
+		{
+			// idx was validated when counting the used iters
+			cc_listIter_t* next = iter->next;
+			idx = cc_listBlock_find(blocks, count, iter);
+			if(used[idx] < CC_LISTBLOCK_SIZE)
+			{
+				iter->next = iters;
+				iters      = iter;
+			}
+			iter = next;
+		}
+		pool->iters        = iters;
+		pool->count       -= release*CC_LISTBLOCK_SIZE;
+		pool->block_count -= release;
+
+		// free blocks and rebuild the list of blocks
+		pool->blocks = NULL;
+		for(i = 0; i < count; ++i)
+		{
+			block = blocks[i];
+			if(used[i] == CC_LISTBLOCK_SIZE)
+			{
+				FREE(block);
+			}
+			else
+			{
+				block->next  = pool->blocks;
+				pool->blocks = block;
+			}
+		}
+	}
+}
+
+static void cc_listPool_trimGlobal(void)
+{
 	cc_listPool_t* pool = &g_list_pool;
 
-	if(iters == NULL)
+	// the scratch arrays are allocated outside of the lock
+	// so that other threads are not stalled by MALLOC
+	pthread_mutex_lock(&pool->mutex);
+	int capacity = pool->block_count;
+	pthread_mutex_unlock(&pool->mutex);
+
+	if(capacity == 0)
 	{
-		// ignore
 		return;
 	}
 
-	// count iters and find tail iter
-	size_t         count = 1;
-	cc_listIter_t* tail  = iters;
-	while(tail->next)
+	cc_listBlock_t** blocks;
+	int*             used;
+	blocks = (cc_listBlock_t**)
+	         MALLOC(capacity*sizeof(cc_listBlock_t*));
+	used   = (int*) MALLOC(capacity*sizeof(int));
+	if((blocks == NULL) || (used == NULL))
 	{
-		++count;
-		tail = tail->next;
+		// silently fail
+		FREE(blocks);
+		FREE(used);
+		return;
 	}
 
+	pthread_mutex_lock(&pool->mutex);
+	cc_listPool_trimLocked(pool, capacity, blocks, used);
+	pool->count_trim = pool->count;
+	pthread_mutex_unlock(&pool->mutex);
+
+	FREE(blocks);
+	FREE(used);
+}
+
+static void
+cc_listPool_putGlobal(cc_listIter_t* iters,
+                      cc_listIter_t* tail, size_t count)
+{
+	ASSERT(iters);
+	ASSERT(tail);
+
+	cc_listPool_t* pool = &g_list_pool;
+	int            trim = 0;
+
 	pthread_mutex_lock(&pool->mutex);
 
 	// insert iters into free iters
@@ -177,11 +388,13 @@ static void cc_listPool_put(cc_listIter_t* iters)
 	pool->count += count;
 
 	// free all blocks when not needed
-	pool->refcount -= count;
-	if(pool->refcount == 0)
+	if(atomic_fetch_sub(&pool->refcount, count) == count)
 	{
-		pool->iters = NULL;
-		pool->count = 0;
+		pool->iters       = NULL;
+		pool->count       = 0;
+		pool->block_count = 0;
+
+		pool->count_trim = 0;
 
 		cc_listBlock_t* block = pool->blocks;
 		while(block)
@@ -191,8 +404,192 @@ static void cc_listPool_put(cc_listIter_t* iters)
 			block = pool->blocks;
 		}
 	}
+	else if((pool->count > atomic_load(&pool->refcount)) &&
+	        (pool->count >= pool->count_trim +
+	                        CC_LISTTRIM_BLOCKS*CC_LISTBLOCK_SIZE))
+	{
+		// release free blocks when usage drops
+		// count_trim prevents other threads from also
+		// requesting a trim before this one completes
+		pool->count_trim = pool->count;
+		trim = 1;
+	}
 
 	pthread_mutex_unlock(&pool->mutex);
+
+	if(trim)
+	{
+		cc_listPool_trimGlobal();
+	}
+}
+
+/***********************************************************
+* private - thread listIter cache                          *
+***********************************************************/
+
+static void cc_listCache_flush(cc_listCache_t* self)
+{
+	ASSERT(self);
+
+	if(self->count == 0)
+	{
+		return;
+	}
+
+	cc_listIter_t* tail = self->iters;
+	while(tail->next)
+	{
+		tail = tail->next;
+	}
+
+	cc_listPool_putGlobal(self->iters, tail, self->count);
+	self->iters = NULL;
+	self->count = 0;
+}
+
+static void cc_listCache_destruct(void* arg)
+{
+	ASSERT(arg);
+
+	cc_listCache_t* self = (cc_listCache_t*) arg;
+
+	// return the iters of an exiting thread
+	cc_listCache_flush(self);
+	free(self);
+	g_list_cache = NULL;
+}
+
+static void cc_listCache_once(void)
+{
+	if(pthread_key_create(&g_list_key,
+	                      cc_listCache_destruct) != 0)
+	{
+		LOGE("pthread_key_create failed");
+	}
+}
+
+static cc_listCache_t* cc_listCache_get(void)
+{
+	if(g_list_cache)
+	{
+		return g_list_cache;
+	}
+
+	pthread_once(&g_list_once, cc_listCache_once);
+
+	// the cache is internal state which is not included
+	// in the MEMCOUNT/MEMSIZE totals
+	cc_listCache_t* self;
+	self = (cc_listCache_t*) calloc(1, sizeof(cc_listCache_t));
+	if(self == NULL)
+	{
+		LOGE("calloc failed");
+		return NULL;
+	}
+
+	if(pthread_setspecific(g_list_key, (const void*) self) != 0)
+	{
+		LOGE("pthread_setspecific failed");
+		free(self);
+		return NULL;
+	}
+
+	g_list_cache = self;
+
+	return self;
+}
+
+static cc_listIter_t* cc_listPool_get(size_t sets)
+{
+	ASSERT(sets > 0);
+
+	size_t count = sets*CC_LISTSET_SIZE;
+
+	cc_listCache_t* cache = cc_listCache_get();
+	if((cache == NULL) || (cache->count < count))
+	{
+		return cc_listPool_getGlobal(sets);
+	}
+
+	// get the sets of free iters from the cache
+	size_t i;
+	cc_listIter_t* iters = cache->iters;
+	cc_listIter_t* tail  = NULL;
+	for(i = 0; i < count; ++i)
+	{
+		tail         = cache->iters;
+		cache->iters = cache->iters->next;
+	}
+	tail->next = NULL;
+
+	cache->count -= count;
+
+	return iters;
+}
+
+static void cc_listPool_put(cc_listIter_t* iters)
+{
+	// iters may be NULL
+
+	if(iters == NULL)
+	{
+		// ignore
+		return;
+	}
+
+	// count iters and find tail iter
+	size_t         count = 1;
+	cc_listIter_t* tail  = iters;
+	while(tail->next)
+	{
+		++count;
+		tail = tail->next;
+	}
+
+	cc_listCache_t* cache = cc_listCache_get();
+	if(cache == NULL)
+	{
+		cc_listPool_putGlobal(iters, tail, count);
+		return;
+	}
+
+	// insert iters into the cache
+	tail->next    = cache->iters;
+	cache->iters  = iters;
+	cache->count += count;
+
+	// return all iters when the cache holds every iter
+	// outside the global pool so the blocks may be freed
+	if(atomic_load(&g_list_pool.refcount) == cache->count)
+	{
+		cc_listCache_flush(cache);
+		return;
+	}
+
+	// return the excess iters in a batch
+	if(cache->count > CC_LISTCACHE_SIZE)
+	{
+		size_t keep = CC_LISTCACHE_SIZE/2;
+
+		size_t i;
+		cc_listIter_t* last = cache->iters;
+		for(i = 1; i < keep; ++i)
+		{
+			last = last->next;
+		}
+
+		iters = last->next;
+		count = cache->count - keep;
+		tail  = iters;
+		while(tail->next)
+		{
+			tail = tail->next;
+		}
+
+		last->next   = NULL;
+		cache->count = keep;
+		cc_listPool_putGlobal(iters, tail, count);
+	}
 }
 
 /***********************************************************
@@ -339,10 +736,16 @@ cc_listIter_new(cc_list_t* list, cc_listIter_t* prev,
 		self        = list->iters;
 		list->iters = list->iters->next;
 	}
+	else if(list->flags & CC_LIST_FLAG_ARENA)
+	{
+		self = (cc_listIter_t*)
+		       cc_arena_alloc(list->arena,
+		                      sizeof(cc_listIter_t));
+	}
 	else
 	{
 		// get a set of free iters
-		self = cc_listPool_get();
+		self = cc_listPool_get(1);
 
 		// keep first iter from set and
 		// add remaining to list of free iters
@@ -408,16 +811,197 @@ cc_listIter_delete(cc_listIter_t** _self, cc_list_t* list)
 	return data;
 }
 
-static cc_list_t* cc_list_newFlags(int flags)
+static cc_listIter_t*
+cc_listIter_merge(cc_listIter_t* a, cc_listIter_t* b,
+                  cc_listcmp_fn compare)
 {
+	// a and b may be NULL
+	ASSERT(compare);
+
+	// merge the sll of iters where a precedes b and ties
+	// are taken from a so the merge is stable
+	cc_listIter_t  head = { .next=NULL };
+	cc_listIter_t* tail = &head;
+	while(a && b)
+	{
+		if((*compare)(b->data, a->data) < 0)
+		{
+			tail->next = b;
+			b          = b->next;
+		}
+		else
+		{
+			tail->next = a;
+			a          = a->next;
+		}
+		tail = tail->next;
+	}
+	tail->next = a ? a : b;
+
+	return head.next;
+}
+
+static void
+cc_list_relink(cc_list_t* self, cc_listIter_t* head)
+{
+	ASSERT(self);
+
+	// restore the prev links of a sll of iters
+	cc_listIter_t* prev = NULL;
+	cc_listIter_t* iter = head;
+	while(iter)
+	{
+		iter->prev = prev;
+		prev       = iter;
+		iter       = iter->next;
+	}
+
+	self->head = head;
+	self->tail = prev;
+}
+
+static int cc_list_reserveIters(cc_list_t* self, int count)
+{
+	ASSERT(self);
+	ASSERT(count > 0);
+
+	// count the local free iters
+	int            avail = 0;
+	cc_listIter_t* iter  = self->iters;
+	while(iter && (avail < count))
+	{
+		++avail;
+		iter = iter->next;
+	}
+
+	if(avail == count)
+	{
+		return 1;
+	}
+
+	// add the missing iters to the local free iters
+	int i;
+	int need = count - avail;
+	if(self->flags & CC_LIST_FLAG_CMALLOC)
+	{
+		for(i = 0; i < need; ++i)
+		{
+			iter = (cc_listIter_t*)
+			       calloc(1, sizeof(cc_listIter_t));
+			if(iter == NULL)
+			{
+				LOGE("calloc failed");
+				return 0;
+			}
+
+			iter->next  = self->iters;
+			self->iters = iter;
+		}
+	}
+	else if(self->flags & CC_LIST_FLAG_ARENA)
+	{
+		cc_listIter_t* array;
+		array = (cc_listIter_t*)
+		        cc_arena_alloc(self->arena,
+		                       need*sizeof(cc_listIter_t));
+		if(array == NULL)
+		{
+			return 0;
+		}
+
+		for(i = 0; i < need; ++i)
+		{
+			array[i].next = self->iters;
+			self->iters   = &array[i];
+		}
+	}
+	else
+	{
+		// get all sets of free iters in one batch
+		size_t sets = (need + CC_LISTSET_SIZE - 1)/
+		              CC_LISTSET_SIZE;
+		cc_listIter_t* iters = cc_listPool_get(sets);
+		if(iters == NULL)
+		{
+			LOGE("cc_listPool_get failed");
+			return 0;
+		}
+
+		cc_listIter_t* tail = iters;
+		while(tail->next)
+		{
+			tail = tail->next;
+		}
+		tail->next  = self->iters;
+		self->iters = iters;
+	}
+
+	return 1;
+}
+
+static void
+cc_list_linkArray(cc_list_t* self, cc_listIter_t* prev,
+                  cc_listIter_t* next, int count,
+                  const void** data)
+{
+	// prev and next can be NULL
+	ASSERT(self);
+	ASSERT(count > 0);
+	ASSERT(data);
+
+	// link the reserved iters in a single pass
+	int i;
+	cc_listIter_t* iter;
+	for(i = 0; i < count; ++i)
+	{
+		ASSERT(data[i]);
+
+		iter        = self->iters;
+		self->iters = iter->next;
+		iter->prev  = prev;
+		iter->data  = data[i];
+		if(prev)
+		{
+			prev->next = iter;
+		}
+		else
+		{
+			self->head = iter;
+		}
+		prev = iter;
+	}
+
+	prev->next = next;
+	if(next)
+	{
+		next->prev = prev;
+	}
+	else
+	{
+		self->tail = prev;
+	}
+	self->size += count;
+}
+
+static cc_list_t*
+cc_list_newFlags(int flags, cc_arena_t* arena)
+{
+	// arena may be NULL
+
 	cc_list_t* self;
 	if(flags & CC_LIST_FLAG_CMALLOC)
 	{
 		self = (cc_list_t*) calloc(1, sizeof(cc_list_t));
 	}
+	else if(flags & CC_LIST_FLAG_ARENA)
+	{
+		self = (cc_list_t*)
+		       cc_arena_calloc(arena, 1, sizeof(cc_list_t));
+	}
 	else
 	{
-		self = (cc_list_t*) CALLOC(1, sizeof(cc_list_t));
+		self = (cc_list_t*)
+		       CALLOC_TAG(CC_MEMTAG_LIST, 1, sizeof(cc_list_t));
 	}
 
 	if(self == NULL)
@@ -427,6 +1011,7 @@ static cc_list_t* cc_list_newFlags(int flags)
 	}
 
 	self->flags = flags;
+	self->arena = arena;
 
 	return self;
 }
@@ -440,16 +1025,34 @@ static cc_list_t* cc_list_newFlags(int flags)
 // but cannot use the cc_memory tracking without deadlocks
 cc_list_t* cc_list_newCMalloc(void)
 {
-	return cc_list_newFlags(CC_LIST_FLAG_CMALLOC);
+	return cc_list_newFlags(CC_LIST_FLAG_CMALLOC, NULL);
 }
 
 /***********************************************************
 * public                                                   *
 ***********************************************************/
 
+void cc_listPool_trim(void)
+{
+	// return the iters cached by the calling thread
+	if(g_list_cache)
+	{
+		cc_listCache_flush(g_list_cache);
+	}
+
+	cc_listPool_trimGlobal();
+}
+
 cc_list_t* cc_list_new(void)
 {
-	return cc_list_newFlags(0);
+	return cc_list_newFlags(0, NULL);
+}
+
+cc_list_t* cc_list_newArena(cc_arena_t* arena)
+{
+	ASSERT(arena);
+
+	return cc_list_newFlags(CC_LIST_FLAG_ARENA, arena);
 }
 
 void cc_list_delete(cc_list_t** _self)
@@ -469,6 +1072,10 @@ void cc_list_delete(cc_list_t** _self)
 		{
 			free(self);
 		}
+		else if(self->flags & CC_LIST_FLAG_ARENA)
+		{
+			// list and iters are owned by the arena
+		}
 		else
 		{
 			// put the list of free iters
@@ -705,6 +1312,70 @@ cc_list_append(cc_list_t* self, cc_listIter_t* iter,
 	}
 }
 
+int cc_list_insertArray(cc_list_t* self,
+                       cc_listIter_t* iter,
+                       int count, const void** data)
+{
+	// iter may be null for empty list or to insert at head
+	// otherwise the array is inserted before iter
+	ASSERT(self);
+	ASSERT(count >= 0);
+	ASSERT(data || (count == 0));
+
+	if(count == 0)
+	{
+		return 1;
+	}
+
+	if(cc_list_reserveIters(self, count) == 0)
+	{
+		return 0;
+	}
+
+	if(iter)
+	{
+		cc_list_linkArray(self, iter->prev, iter, count, data);
+	}
+	else
+	{
+		cc_list_linkArray(self, NULL, self->head, count, data);
+	}
+
+	return 1;
+}
+
+int cc_list_appendArray(cc_list_t* self,
+                        cc_listIter_t* iter,
+                        int count, const void** data)
+{
+	// iter may be null for empty list or to append at tail
+	// otherwise the array is appended after iter
+	ASSERT(self);
+	ASSERT(count >= 0);
+	ASSERT(data || (count == 0));
+
+	if(count == 0)
+	{
+		return 1;
+	}
+
+	if(cc_list_reserveIters(self, count) == 0)
+	{
+		return 0;
+	}
+
+	if(iter)
+	{
+		cc_list_linkArray(self, iter, iter->next, count, data);
+	}
+	else
+	{
+		cc_list_linkArray(self, self->tail, NULL, count, data);
+	}
+
+	return 1;
+}
+
 const void*
 cc_list_replace(cc_listIter_t* iter,
                 const void* data)
@@ -776,6 +1447,7 @@ void cc_list_swap(cc_list_t* fromList, cc_list_t* toList,
 	ASSERT(fromList);
 	ASSERT(toList);
 	ASSERT(from);
+	ASSERT(fromList->arena == toList->arena);
 
 	if(fromList == toList)
 	{
@@ -802,6 +1474,7 @@ void cc_list_swapn(cc_list_t* fromList, cc_list_t* toList,
 	ASSERT(fromList);
 	ASSERT(toList);
 	ASSERT(from);
+	ASSERT(fromList->arena == toList->arena);
 
 	if(fromList == toList)
 	{
@@ -825,6 +1498,7 @@ void cc_list_appendList(cc_list_t* self, cc_list_t* from)
 {
 	ASSERT(self);
 	ASSERT(from);
+	ASSERT(self->arena == from->arena);
 
 	if(from->size == 0)
 	{
@@ -854,6 +1528,7 @@ void cc_list_insertList(cc_list_t* self, cc_list_t* from)
 {
 	ASSERT(self);
 	ASSERT(from);
+	ASSERT(self->arena == from->arena);
 
 	if(from->size == 0)
 	{
@@ -878,3 +1553,71 @@ void cc_list_insertList(cc_list_t* self, cc_list_t* from)
 	from->tail = NULL;
 	from->size = 0;
 }
+
+void cc_list_sort(cc_list_t* self, cc_listcmp_fn compare)
+{
+	ASSERT(self);
+	ASSERT(compare);
+
+	if(self->size < 2)
+	{
+		return;
+	}
+
+	// bottom-up merge sort where bin[i] holds a sorted run
+	// of 2^i iters and higher bins hold earlier iters
+	cc_listIter_t* bin[CC_LIST_SORT_BINS] = { NULL };
+
+	int            i;
+	cc_listIter_t* run;
+	cc_listIter_t* next;
+	cc_listIter_t* iter = self->head;
+	while(iter)
+	{
+		next       = iter->next;
+		iter->next = NULL;
+
+		run = iter;
+		for(i = 0; bin[i]; ++i)
+		{
+			run    = cc_listIter_merge(bin[i], run, compare);
+			bin[i] = NULL;
+		}
+		bin[i] = run;
+
+		iter = next;
+	}
+
+	run = NULL;
+	for(i = 0; i < CC_LIST_SORT_BINS; ++i)
+	{
+		if(bin[i])
+		{
+			run = cc_listIter_merge(bin[i], run, compare);
+		}
+	}
+
+	cc_list_relink(self, run);
+}
+
+void cc_list_mergeSorted(cc_list_t* self, cc_list_t* from,
+                         cc_listcmp_fn compare)
+{
+	ASSERT(self);
+	ASSERT(from);
+	ASSERT(compare);
+	ASSERT(self->arena == from->arena);
+
+	if(from->size == 0)
+	{
+		return;
+	}
+
+	cc_listIter_t* head;
+	head = cc_listIter_merge(self->head, from->head, compare);
+	cc_list_relink(self, head);
+	self->size += from->size;
+	from->head = NULL;
+	from->tail = NULL;
+	from->size = 0;
+}
@@ -24,6 +24,8 @@
 #ifndef cc_list_H
 #define cc_list_H
 
+#include "cc_arena.h"
+
 typedef int (*cc_listcmp_fn)(const void* a, const void* b);
 
 typedef struct cc_listIter_s
@@ -40,9 +42,18 @@ typedef struct
 	cc_listIter_t* head;
 	cc_listIter_t* tail;
 	cc_listIter_t* iters;
+	cc_arena_t*    arena;
 } cc_list_t;
 
+// cc_listPool_trim releases free iter blocks to the system
+// including the iters cached by the calling thread
+void           cc_listPool_trim(void);
+
+// lists created with an arena allocate the list and iters
+// from the arena and iters must not be moved between
+// arena and non-arena lists
 cc_list_t*     cc_list_new(void);
+cc_list_t*     cc_list_newArena(cc_arena_t* arena);
 void           cc_list_delete(cc_list_t** _self);
 void           cc_list_discard(cc_list_t* self);
 int            cc_list_size(const cc_list_t* self);
@@ -72,6 +83,14 @@ cc_listIter_t* cc_list_insert(cc_list_t* self,
 cc_listIter_t* cc_list_append(cc_list_t* self,
                               cc_listIter_t* iter,
                               const void* data);
+int            cc_list_insertArray(cc_list_t* self,
+                                   cc_listIter_t* iter,
+                                   int count,
+                                   const void** data);
+int            cc_list_appendArray(cc_list_t* self,
+                                   cc_listIter_t* iter,
+                                   int count,
+                                   const void** data);
 const void*    cc_list_replace(cc_listIter_t* iter,
                                const void* data);
 const void*    cc_list_remove(cc_list_t* self,
@@ -94,5 +113,10 @@ void           cc_list_appendList(cc_list_t* self,
                                   cc_list_t* from);
 void           cc_list_insertList(cc_list_t* self,
                                   cc_list_t* from);
+void           cc_list_sort(cc_list_t* self,
+                            cc_listcmp_fn compare);
+void           cc_list_mergeSorted(cc_list_t* self,
+                                   cc_list_t* from,
+                                   cc_listcmp_fn compare);
 
 #endif
@@ -34,13 +34,27 @@
 #include "cc_memory.h"
 #include "cc_mumurhash3.h"
 #include "cc_log.h"
+#include "cc_slab.h"
 
-#define CC_MAP_FLAG_CMALLOC 1
+#define CC_MAP_FLAG_CMALLOC     1
+#define CC_MAP_FLAG_ARENA       2
+#define CC_MAP_FLAG_INCREMENTAL 4
 
+// stack buffer size for formatted keys
+// longer keys are formatted into a heap buffer
 #define CC_MAP_KEYLEN 256
 
 #define CC_MAP_CAPACITY 16
 
+// the map is shrunk automatically to half capacity once
+// the size drops below 1/CC_MAP_SHRINK of the capacity
+#define CC_MAP_SHRINK 4
+
+// number of old buckets split per add/remove during an
+// incremental resize which completes the resize well before
+// the next resize is required
+#define CC_MAP_SPLIT_STEP 4
+
 #define CC_MAP_IDX(map, hash) (hash/map->elements)
 
 // protected
@@ -50,8 +64,6 @@ cc_list_t* cc_list_newCMalloc(void);
 * private - mapNode                                        *
 ***********************************************************/
 
-// note that key must be 8-byte aligned for
-// cc_mumurhash3 and cc_mapNode_cmp to work
 typedef struct cc_mapNode_s
 {
 	const void* val;
@@ -77,8 +89,7 @@ static uint8_t* cc_mapNode_key(cc_mapNode_t* self)
 
 static cc_mapNode_t*
 cc_mapNode_new(cc_map_t* map, const void* val,
-               uint32_t hash, int idx, int len,
-               const uint8_t* key)
+               uint32_t hash, int len, const uint8_t* key)
 {
 	// val may be NULL
 	ASSERT(map);
@@ -93,9 +104,15 @@ cc_mapNode_new(cc_map_t* map, const void* val,
 	{
 		self = (cc_mapNode_t*) calloc(1, size);
 	}
+	else if(map->flags & CC_MAP_FLAG_ARENA)
+	{
+		self = (cc_mapNode_t*)
+		       cc_arena_calloc(map->arena, 1, size);
+	}
 	else
 	{
-		self = (cc_mapNode_t*) CALLOC(1, size);
+		self = (cc_mapNode_t*)
+		       cc_slab_callocTag(CC_MEMTAG_MAP, size);
 	}
 
 	if(self == NULL)
@@ -131,9 +148,14 @@ cc_mapNode_delete(cc_mapNode_t** _self, cc_map_t* map)
 		{
 			free(self);
 		}
+		else if(map->flags & CC_MAP_FLAG_ARENA)
+		{
+			// node is owned by the arena
+		}
 		else
 		{
-			FREE(self);
+			cc_slab_freeTag(CC_MEMTAG_MAP, self,
+			                cc_mapNode_sizeof(self));
 		}
 		*_self = NULL;
 	}
@@ -167,88 +189,422 @@ cc_mapNode_cmp(cc_mapNode_t* self,
 		return -1;
 	}
 
-	const uint64_t* key64a;
-	const uint64_t* key64b;
-	key64a = (const uint64_t*) cc_mapNode_key(self);
-	key64b = (const uint64_t*) key;
-
 	// otherwise compare key bytes
-	// compare initial bytes 8 at a time
-	int cnt = len/8;
-	int idx = 0;
-	while(cnt)
+	return memcmp((const void*) cc_mapNode_key(self),
+	              (const void*) key, len);
+}
+
+static int cc_mapNode_sortcmp(const void* a, const void* b)
+{
+	ASSERT(a);
+	ASSERT(b);
+
+	cc_mapNode_t* node = (cc_mapNode_t*) b;
+	return cc_mapNode_cmp((cc_mapNode_t*) a, node->hash,
+	                      node->len, cc_mapNode_key(node));
+}
+
+/***********************************************************
+* private - mapKey                                         *
+***********************************************************/
+
+static const uint8_t*
+cc_mapKey_bytes(const cc_mapKey_t* self, int* _len)
+{
+	ASSERT(self);
+	ASSERT(_len);
+
+	if(self->len == 0)
 	{
-		if(key64a[idx] > key64b[idx])
+		// pointer itself is the key
+		*_len = sizeof(void*);
+		return (const uint8_t*) &self->key;
+	}
+
+	*_len = self->len;
+	return (const uint8_t*) self->key;
+}
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static char*
+cc_map_format(const cc_map_t* self, char* buf, int* _len,
+              const char* fmt, va_list argptr)
+{
+	ASSERT(self);
+	ASSERT(buf);
+	ASSERT(_len);
+	ASSERT(fmt);
+
+	va_list argptr2;
+	va_copy(argptr2, argptr);
+
+	// format short keys into the stack buffer
+	char* key = buf;
+	int   len = vsnprintf(buf, CC_MAP_KEYLEN, fmt, argptr);
+	if(len < 0)
+	{
+		LOGE("invalid fmt=%s", fmt);
+		key = NULL;
+	}
+	else if(len >= CC_MAP_KEYLEN)
+	{
+		if(self->flags & CC_MAP_FLAG_CMALLOC)
+		{
+			key = (char*) malloc(len + 1);
+		}
+		else
+		{
+			key = (char*) MALLOC(len + 1);
+		}
+
+		if(key == NULL)
 		{
-			return 1;
+			LOGE("MALLOC failed");
 		}
-		else if(key64a[idx] < key64b[idx])
+		else
 		{
-			return -1;
+			vsnprintf(key, len + 1, fmt, argptr2);
 		}
+	}
+	va_end(argptr2);
+
+	*_len = len + 1;
+
+	return key;
+}
+
+static void
+cc_map_formatFree(const cc_map_t* self, char* buf, char* key)
+{
+	ASSERT(self);
+	ASSERT(buf);
+
+	if((key == NULL) || (key == buf))
+	{
+		return;
+	}
+
+	if(self->flags & CC_MAP_FLAG_CMALLOC)
+	{
+		free(key);
+	}
+	else
+	{
+		FREE(key);
+	}
+}
+
+static cc_listIter_t**
+cc_map_newBuckets(cc_map_t* self, int capacity)
+{
+	ASSERT(self);
+
+	cc_listIter_t** buckets;
+	if(self->flags & CC_MAP_FLAG_CMALLOC)
+	{
+		buckets = (cc_listIter_t**)
+		          calloc(capacity, sizeof(cc_listIter_t*));
+	}
+	else if(self->flags & CC_MAP_FLAG_ARENA)
+	{
+		buckets = (cc_listIter_t**)
+		          cc_arena_calloc(self->arena, capacity,
+		                          sizeof(cc_listIter_t*));
+	}
+	else
+	{
+		buckets = (cc_listIter_t**)
+		          CALLOC_TAG(CC_MEMTAG_MAP, capacity,
+		                     sizeof(cc_listIter_t*));
+	}
 
-		++idx;
-		--cnt;
+	if(buckets == NULL)
+	{
+		LOGE("CALLOC failed");
 	}
 
-	const uint32_t* key32a = (const uint32_t*) key64a;
-	const uint32_t* key32b = (const uint32_t*) key64b;
+	return buckets;
+}
+
+static void
+cc_map_deleteBuckets(cc_map_t* self, cc_listIter_t*** _buckets)
+{
+	ASSERT(self);
+	ASSERT(_buckets);
 
-	// compare bytes 4 at a time
-	cnt = len % 8;
-	idx = 2*idx;
-	if(cnt >= 4)
+	cc_listIter_t** buckets = *_buckets;
+	if(buckets)
 	{
-		if(key32a[idx] > key32b[idx])
+		if(self->flags & CC_MAP_FLAG_CMALLOC)
+		{
+			free(buckets);
+		}
+		else if(self->flags & CC_MAP_FLAG_ARENA)
 		{
-			return 1;
+			// buckets are owned by the arena
 		}
-		else if(key32a[idx] < key32b[idx])
+		else
 		{
-			return -1;
+			FREE(buckets);
 		}
+		*_buckets = NULL;
+	}
+}
 
-		++idx;
-		cnt -= 4;
+// returns the bucket which contains hash and the elements
+// per bucket for the bucket array containing the bucket
+static cc_listIter_t**
+cc_map_bucket(const cc_map_t* self, uint32_t hash,
+              uint32_t* _elements)
+{
+	ASSERT(self);
+	ASSERT(_elements);
+
+	// check if the bucket has not been split yet
+	if(self->buckets1)
+	{
+		uint32_t elements1 = 2*((uint32_t) self->elements);
+		uint32_t idx1      = hash/elements1;
+		if(idx1 >= (uint32_t) self->split)
+		{
+			*_elements = elements1;
+			return &self->buckets1[idx1];
+		}
 	}
 
-	const uint8_t* key8a = (const uint8_t*) key64a;
-	const uint8_t* key8b = (const uint8_t*) key64b;
+	*_elements = self->elements;
+	return &self->buckets[CC_MAP_IDX(self, hash)];
+}
+
+static cc_listIter_t*
+cc_map_nextBucket(const cc_map_t* self, uint32_t hash)
+{
+	ASSERT(self);
 
-	// compare remaining bytes one at a time
-	idx = 4*idx;
-	while(cnt)
+	// find the first node of the next used bucket
+	int i;
+	int idx = CC_MAP_IDX(self, hash);
+	for(i = idx + 1; i < self->capacity; ++i)
 	{
-		if(key8a[idx] > key8b[idx])
+		cc_listIter_t* iter;
+		if(self->buckets1 && ((i/2) >= self->split))
 		{
-			return 1;
+			// odd buckets are contained by the even
+			// buckets of the unsplit region
+			if(i % 2)
+			{
+				continue;
+			}
+			iter = self->buckets1[i/2];
 		}
-		else if(key8a[idx] < key8b[idx])
+		else
 		{
-			return -1;
+			iter = self->buckets[i];
 		}
 
-		++idx;
-		--cnt;
+		if(iter)
+		{
+			return iter;
+		}
 	}
 
-	return 0;
+	return NULL;
 }
 
-/***********************************************************
-* private                                                  *
-***********************************************************/
+static void
+cc_map_split(cc_map_t* self, cc_listIter_t* iter, int k)
+{
+	// iter may be NULL
+	ASSERT(self);
 
-static cc_map_t* cc_map_newFlags(int flags)
+	// split bucket k into buckets i and j which are
+	// indexed by the current capacity
+	int i = 2*k;
+	int j = i + 1;
+	self->buckets[i] = NULL;
+	self->buckets[j] = NULL;
+
+	if(iter == NULL)
+	{
+		return;
+	}
+
+	// update bucket[i]
+	int           idx;
+	cc_mapNode_t* node;
+	node = (cc_mapNode_t*) cc_list_peekIter(iter);
+	idx  = CC_MAP_IDX(self, node->hash);
+	if(idx == i)
+	{
+		self->buckets[i] = iter;
+	}
+
+	// update bucket[j]
+	while(iter)
+	{
+		node = (cc_mapNode_t*) cc_list_peekIter(iter);
+		idx  = CC_MAP_IDX(self, node->hash);
+		if(idx == j)
+		{
+			self->buckets[j] = iter;
+			break;
+		}
+		else if(idx > j)
+		{
+			break;
+		}
+
+		iter = cc_list_next(iter);
+	}
+}
+
+static void
+cc_map_splitStep(cc_map_t* self, int count)
+{
+	ASSERT(self);
+
+	if(self->buckets1 == NULL)
+	{
+		return;
+	}
+
+	int capacity1 = self->capacity/2;
+	while((count > 0) && (self->split < capacity1))
+	{
+		cc_map_split(self, self->buckets1[self->split],
+		             self->split);
+		++self->split;
+		--count;
+	}
+
+	// release the old buckets once every bucket was split
+	if(self->split == capacity1)
+	{
+		cc_map_deleteBuckets(self, &self->buckets1);
+		self->split = 0;
+	}
+}
+
+static int cc_map_roundCapacity(int size)
+{
+	// round up to a power of two
+	int capacity = CC_MAP_CAPACITY;
+	while((capacity < size) && (capacity < (INT_MAX/2)))
+	{
+		capacity *= 2;
+	}
+
+	return capacity;
+}
+
+static void cc_map_rebuild(cc_map_t* self)
 {
+	ASSERT(self);
+	ASSERT(self->buckets1 == NULL);
+
+	// rebuild the empty buckets from the sorted nodes
+	int            idx;
+	cc_mapNode_t*  node;
+	cc_listIter_t* iter = cc_list_head(self->nodes);
+	while(iter)
+	{
+		node = (cc_mapNode_t*) cc_list_peekIter(iter);
+		idx  = CC_MAP_IDX(self, node->hash);
+		if(self->buckets[idx] == NULL)
+		{
+			self->buckets[idx] = iter;
+		}
+		iter = cc_list_next(iter);
+	}
+}
+
+static int
+cc_map_resize(cc_map_t* self, int capacity)
+{
+	ASSERT(self);
+
+	if(capacity == self->capacity)
+	{
+		return 1;
+	}
+
+	cc_listIter_t** buckets;
+	buckets = cc_map_newBuckets(self, capacity);
+	if(buckets == NULL)
+	{
+		return 0;
+	}
+
+	// any incremental resize is replaced
+	cc_map_deleteBuckets(self, &self->buckets1);
+	cc_map_deleteBuckets(self, &self->buckets);
+	self->split    = 0;
+	self->capacity = capacity;
+	self->elements = (uint32_t)
+	                 (((uint64_t) UINT_MAX + 1)/
+	                  ((uint64_t) self->capacity));
+	self->buckets  = buckets;
+
+	cc_map_rebuild(self);
+
+	return 1;
+}
+
+static void
+cc_map_autoShrink(cc_map_t* self)
+{
+	ASSERT(self);
+
+	// arena buckets are not released until the arena is
+	// reset so shrinking would only waste memory
+	if(self->flags & CC_MAP_FLAG_ARENA)
+	{
+		return;
+	}
+
+	// shrinking rebuilds every bucket which would undo the
+	// bounded latency of incremental maps so these are only
+	// shrunk by an explicit call to cc_map_shrink
+	if(self->flags & CC_MAP_FLAG_INCREMENTAL)
+	{
+		return;
+	}
+
+	int size     = cc_list_size(self->nodes);
+	int capacity = self->capacity/2;
+	if((capacity < self->reserve) ||
+	   (capacity < CC_MAP_CAPACITY) ||
+	   (size >= self->capacity/CC_MAP_SHRINK))
+	{
+		return;
+	}
+
+	// silently fail
+	cc_map_resize(self, capacity);
+}
+
+static cc_map_t*
+cc_map_newFlags(int flags, cc_arena_t* arena, int capacity)
+{
+	// arena may be NULL
+
 	cc_map_t* self;
 	if(flags & CC_MAP_FLAG_CMALLOC)
 	{
 		self = (cc_map_t*) calloc(1, sizeof(cc_map_t));
 	}
+	else if(flags & CC_MAP_FLAG_ARENA)
+	{
+		self = (cc_map_t*)
+		       cc_arena_calloc(arena, 1, sizeof(cc_map_t));
+	}
 	else
 	{
-		self = (cc_map_t*) CALLOC(1, sizeof(cc_map_t));
+		self = (cc_map_t*)
+		       CALLOC_TAG(CC_MEMTAG_MAP, 1, sizeof(cc_map_t));
 	}
 
 	if(self == NULL)
@@ -258,24 +614,14 @@ static cc_map_t* cc_map_newFlags(int flags)
 	}
 
 	self->flags    = flags;
+	self->arena    = arena;
 	self->seed     = random();
-	self->capacity = CC_MAP_CAPACITY;
+	self->capacity = cc_map_roundCapacity(capacity);
+	self->reserve  = capacity;
 	self->elements = (uint32_t)
 	                 (((uint64_t) UINT_MAX + 1)/
 	                  ((uint64_t) self->capacity));
-	if(flags & CC_MAP_FLAG_CMALLOC)
-	{
-		self->buckets = (cc_listIter_t**)
-		                calloc(self->capacity,
-		                       sizeof(cc_listIter_t*));
-	}
-	else
-	{
-		self->buckets = (cc_listIter_t**)
-		                CALLOC(self->capacity,
-		                       sizeof(cc_listIter_t*));
-	}
-
+	self->buckets  = cc_map_newBuckets(self, self->capacity);
 	if(self->buckets == NULL)
 	{
 		goto fail_buckets;
@@ -285,6 +631,10 @@ static cc_map_t* cc_map_newFlags(int flags)
 	{
 		self->nodes = cc_list_newCMalloc();
 	}
+	else if(flags & CC_MAP_FLAG_ARENA)
+	{
+		self->nodes = cc_list_newArena(arena);
+	}
 	else
 	{
 		self->nodes = cc_list_new();
@@ -300,23 +650,14 @@ static cc_map_t* cc_map_newFlags(int flags)
 
 	// failure
 	fail_nodes:
-	{
-		if(flags & CC_MAP_FLAG_CMALLOC)
-		{
-			free(self->buckets);
-		}
-		else
-		{
-			FREE(self->buckets);
-		}
-	}
+		cc_map_deleteBuckets(self, &self->buckets);
 	fail_buckets:
 	{
 		if(flags & CC_MAP_FLAG_CMALLOC)
 		{
 			free(self);
 		}
-		else
+		else if((flags & CC_MAP_FLAG_ARENA) == 0)
 		{
 			FREE(self);
 		}
@@ -339,6 +680,30 @@ cc_map_grow(cc_map_t* self)
 	int    capacity2 = 2*self->capacity;
 	size_t size2     = capacity2*sizeof(cc_listIter_t*);
 
+	// start an incremental resize which keeps the old
+	// buckets until they have been split
+	if(self->flags & CC_MAP_FLAG_INCREMENTAL)
+	{
+		// finish the previous resize
+		cc_map_splitStep(self, capacity1);
+
+		cc_listIter_t** buckets2;
+		buckets2 = cc_map_newBuckets(self, capacity2);
+		if(buckets2 == NULL)
+		{
+			return;
+		}
+
+		self->buckets1 = self->buckets;
+		self->split    = 0;
+		self->capacity = capacity2;
+		self->elements = (uint32_t)
+		                 (((uint64_t) UINT_MAX + 1)/
+		                  ((uint64_t) self->capacity));
+		self->buckets  = buckets2;
+		return;
+	}
+
 	// try to grow the capacity
 	cc_listIter_t** buckets2;
 	if(self->flags & CC_MAP_FLAG_CMALLOC)
@@ -346,6 +711,17 @@ cc_map_grow(cc_map_t* self)
 		buckets2 = (cc_listIter_t**)
 		           realloc(self->buckets, size2);
 	}
+	else if(self->flags & CC_MAP_FLAG_ARENA)
+	{
+		// the old buckets are released by the arena
+		buckets2 = (cc_listIter_t**)
+		           cc_arena_alloc(self->arena, size2);
+		if(buckets2)
+		{
+			memcpy((void*) buckets2, (const void*) self->buckets,
+			       capacity1*sizeof(cc_listIter_t*));
+		}
+	}
 	else
 	{
 		buckets2 = (cc_listIter_t**)
@@ -363,65 +739,25 @@ cc_map_grow(cc_map_t* self)
 	self->buckets  = buckets2;
 
 	// update buckets
-	int i;
-	int j;
 	int k;
-	int idx;
-	cc_listIter_t* iter;
-	cc_mapNode_t*  node;
 	for(k = (capacity1 - 1); k >= 0; k -= 1)
 	{
-		iter = self->buckets[k];
-
-		i = 2*k;
-		j = i + 1;
-		self->buckets[i] = NULL;
-		self->buckets[j] = NULL;
-
-		if(iter == NULL)
-		{
-			continue;
-		}
-
-		// update bucket[i]
-		node = (cc_mapNode_t*) cc_list_peekIter(iter);
-		idx  = CC_MAP_IDX(self, node->hash);
-		if(idx == i)
-		{
-			self->buckets[i] = iter;
-		}
-
-		// update bucket[j]
-		while(iter)
-		{
-			node = (cc_mapNode_t*) cc_list_peekIter(iter);
-			idx  = CC_MAP_IDX(self, node->hash);
-			if(idx == j)
-			{
-				self->buckets[j] = iter;
-				break;
-			}
-			else if(idx > j)
-			{
-				break;
-			}
-
-			iter = cc_list_next(iter);
-		}
+		cc_map_split(self, self->buckets[k], k);
 	}
 }
 
 static cc_mapIter_t*
 cc_map_addAt(cc_map_t* self, cc_mapIter_t* miter_at,
-             uint32_t hash, int idx, const void* val,
-             int len, const uint8_t* key)
+             uint32_t hash, cc_listIter_t** bucket,
+             const void* val, int len, const uint8_t* key)
 {
 	// miter_at and val may be NULL
 	ASSERT(self);
+	ASSERT(bucket);
 	ASSERT(key);
 
 	cc_mapNode_t* node;
-	node = cc_mapNode_new(self, val, hash, idx, len, key);
+	node = cc_mapNode_new(self, val, hash, len, key);
 	if(node == NULL)
 	{
 		return NULL;
@@ -432,8 +768,7 @@ cc_map_addAt(cc_map_t* self, cc_mapIter_t* miter_at,
 	cc_mapIter_t* miter;
 	if(miter_at)
 	{
-		if((self->buckets[idx] == NULL) ||
-		   (self->buckets[idx] == miter_at))
+		if((*bucket == NULL) || (*bucket == miter_at))
 		{
 			replace = 1;
 		}
@@ -443,7 +778,7 @@ cc_map_addAt(cc_map_t* self, cc_mapIter_t* miter_at,
 	}
 	else
 	{
-		if(self->buckets[idx] == NULL)
+		if(*bucket == NULL)
 		{
 			replace = 1;
 		}
@@ -461,9 +796,10 @@ cc_map_addAt(cc_map_t* self, cc_mapIter_t* miter_at,
 	// update bucket
 	if(replace)
 	{
-		self->buckets[idx] = miter;
+		*bucket = miter;
 	}
 
+	cc_map_splitStep(self, CC_MAP_SPLIT_STEP);
 	cc_map_grow(self);
 
 	// success
@@ -475,6 +811,97 @@ cc_map_addAt(cc_map_t* self, cc_mapIter_t* miter_at,
 	return NULL;
 }
 
+static cc_mapIter_t*
+cc_map_findHash(const cc_map_t* self, uint32_t hash,
+                int len, const uint8_t* key8)
+{
+	ASSERT(self);
+	ASSERT(key8);
+
+	uint32_t        elements;
+	cc_listIter_t** bucket;
+	bucket = cc_map_bucket(self, hash, &elements);
+
+	uint32_t      idx   = hash/elements;
+	cc_mapIter_t* miter = *bucket;
+	while(miter)
+	{
+		cc_mapNode_t* node;
+		node = (cc_mapNode_t*)
+		       cc_list_peekIter(miter);
+		if((node->hash/elements) != idx)
+		{
+			return NULL;
+		}
+
+		int cmp = cc_mapNode_cmp(node, hash, len, key8);
+		if(cmp == 0)
+		{
+			return miter;
+		}
+		else if(cmp > 0)
+		{
+			return NULL;
+		}
+
+		miter = cc_list_next(miter);
+	}
+
+	return NULL;
+}
+
+static cc_mapIter_t*
+cc_map_addHash(cc_map_t* self, const void* val,
+               uint32_t hash, int len, const uint8_t* key8)
+{
+	// val may be NULL
+	ASSERT(self);
+	ASSERT(key8);
+
+	uint32_t        elements;
+	cc_listIter_t** bucket;
+	bucket = cc_map_bucket(self, hash, &elements);
+
+	// add node to existing bucket
+	uint32_t      idx   = hash/elements;
+	cc_mapIter_t* miter = *bucket;
+	if(miter)
+	{
+		while(miter)
+		{
+			cc_mapNode_t* node;
+			node = (cc_mapNode_t*) cc_list_peekIter(miter);
+			if((node->hash/elements) != idx)
+			{
+				return cc_map_addAt(self, miter, hash, bucket,
+				                    val, len, key8);
+			}
+
+			int cmp = cc_mapNode_cmp(node, hash, len, key8);
+			if(cmp == 0)
+			{
+				return NULL;
+			}
+			else if(cmp > 0)
+			{
+				return cc_map_addAt(self, miter, hash, bucket,
+				                    val, len, key8);
+			}
+
+			miter = cc_list_next(miter);
+		}
+
+		return cc_map_addAt(self, miter, hash, bucket,
+		                    val, len, key8);
+	}
+
+	// add node to an empty bucket
+	// find insert position from next used bucket
+	miter = cc_map_nextBucket(self, hash);
+	return cc_map_addAt(self, miter, hash, bucket,
+	                    val, len, key8);
+}
+
 /***********************************************************
 * protected                                                *
 ***********************************************************/
@@ -484,16 +911,140 @@ cc_map_addAt(cc_map_t* self, cc_mapIter_t* miter_at,
 // but cannot use the cc_memory tracking without deadlocks
 cc_map_t* cc_map_newCMalloc(void)
 {
-	return cc_map_newFlags(CC_MAP_FLAG_CMALLOC);
+	return cc_map_newFlags(CC_MAP_FLAG_CMALLOC, NULL, 0);
 }
 
 /***********************************************************
 * public                                                   *
 ***********************************************************/
 
+int cc_mapKey_initp(cc_mapKey_t* self, const cc_map_t* map,
+                    int len, const void* key)
+{
+	ASSERT(self);
+	ASSERT(map);
+	ASSERT(key);
+
+	self->seed = map->seed;
+	self->len  = len;
+	self->key  = key;
+
+	const uint8_t* key8;
+	key8       = cc_mapKey_bytes(self, &len);
+	self->hash = cc_mumurhash3(self->seed, len, key8);
+
+	return 1;
+}
+
+int cc_mapKey_init(cc_mapKey_t* self, const cc_map_t* map,
+                   const char* key)
+{
+	ASSERT(self);
+	ASSERT(map);
+	ASSERT(key);
+
+	int len = strlen(key) + 1;
+	return cc_mapKey_initp(self, map, len, (const void*) key);
+}
+
 cc_map_t* cc_map_new(void)
 {
-	return cc_map_newFlags(0);
+	return cc_map_newFlags(0, NULL, 0);
+}
+
+cc_map_t* cc_map_newCapacity(int capacity)
+{
+	ASSERT(capacity >= 0);
+
+	return cc_map_newFlags(0, NULL, capacity);
+}
+
+cc_map_t* cc_map_newArena(cc_arena_t* arena)
+{
+	ASSERT(arena);
+
+	return cc_map_newFlags(CC_MAP_FLAG_ARENA, arena, 0);
+}
+
+int cc_map_reserve(cc_map_t* self, int capacity)
+{
+	ASSERT(self);
+	ASSERT(capacity >= 0);
+
+	// the reserved capacity is not released by the
+	// automatic shrink
+	self->reserve = capacity;
+	if(capacity <= self->capacity)
+	{
+		return 1;
+	}
+
+	return cc_map_resize(self, cc_map_roundCapacity(capacity));
+}
+
+void cc_map_shrink(cc_map_t* self)
+{
+	ASSERT(self);
+
+	// silently fail
+	self->reserve = 0;
+	cc_map_resize(self,
+	              cc_map_roundCapacity(cc_list_size(self->nodes)));
+}
+
+uint32_t cc_map_seed(const cc_map_t* self)
+{
+	ASSERT(self);
+
+	return self->seed;
+}
+
+void cc_map_setSeed(cc_map_t* self, uint32_t seed)
+{
+	ASSERT(self);
+
+	if(seed == self->seed)
+	{
+		return;
+	}
+
+	// rehash the nodes which must then be sorted again
+	self->seed = seed;
+
+	cc_mapNode_t*  node;
+	cc_listIter_t* iter = cc_list_head(self->nodes);
+	while(iter)
+	{
+		node       = (cc_mapNode_t*) cc_list_peekIter(iter);
+		node->hash = cc_mumurhash3(seed, node->len,
+		                           cc_mapNode_key(node));
+		iter       = cc_list_next(iter);
+	}
+	cc_list_sort(self->nodes, cc_mapNode_sortcmp);
+
+	// rebuild the buckets
+	cc_map_deleteBuckets(self, &self->buckets1);
+	self->split = 0;
+
+	size_t size = self->capacity*sizeof(cc_listIter_t*);
+	memset((void*) self->buckets, 0, size);
+	cc_map_rebuild(self);
+}
+
+void cc_map_incremental(cc_map_t* self, int incremental)
+{
+	ASSERT(self);
+
+	if(incremental)
+	{
+		self->flags |= CC_MAP_FLAG_INCREMENTAL;
+	}
+	else
+	{
+		// finish an incremental resize
+		cc_map_splitStep(self, self->capacity);
+		self->flags &= ~CC_MAP_FLAG_INCREMENTAL;
+	}
 }
 
 void cc_map_delete(cc_map_t** _self)
@@ -504,14 +1055,18 @@ void cc_map_delete(cc_map_t** _self)
 	if(self)
 	{
 		cc_list_delete(&self->nodes);
+		cc_map_deleteBuckets(self, &self->buckets1);
+		cc_map_deleteBuckets(self, &self->buckets);
 		if(self->flags & CC_MAP_FLAG_CMALLOC)
 		{
-			free(self->buckets);
 			free(self);
 		}
+		else if(self->flags & CC_MAP_FLAG_ARENA)
+		{
+			// map is owned by the arena
+		}
 		else
 		{
-			FREE(self->buckets);
 			FREE(self);
 		}
 		*_self = NULL;
@@ -522,8 +1077,11 @@ void cc_map_discard(cc_map_t* self)
 {
 	ASSERT(self);
 
+	// the discarded map no longer needs to be split
 	size_t size = self->capacity*sizeof(cc_listIter_t*);
 	memset((void*) self->buckets, 0, size);
+	cc_map_deleteBuckets(self, &self->buckets1);
+	self->split = 0;
 
 	cc_mapNode_t* node;
 	cc_listIter_t* iter = cc_list_head(self->nodes);
@@ -551,6 +1109,10 @@ size_t cc_map_sizeof(const cc_map_t* self)
 	size += self->nodes_size;
 	size += self->capacity*sizeof(cc_listIter_t*);
 	size += cc_list_sizeof(self->nodes);
+	if(self->buckets1)
+	{
+		size += (self->capacity/2)*sizeof(cc_listIter_t*);
+	}
 	return size;
 }
 
@@ -598,56 +1160,38 @@ cc_map_findp(const cc_map_t* self, int len, const void* key)
 	ASSERT(self);
 	ASSERT(key);
 
-	// 8-byte aligned temp buffer (if needed)
-	uint64_t key64[CC_MAP_KEYLEN/8];
-
 	const uint8_t* key8 = (const uint8_t*) key;
-	if(len > CC_MAP_KEYLEN)
-	{
-		return NULL;
-	}
-	else if(len == 0)
+	if(len == 0)
 	{
 		// pointer itself is the key
 		len  = sizeof(void*);
 		key8 = (uint8_t*) &key;
 	}
-	else if((((uintptr_t) key) % 8) != 0)
-	{
-		// force 8-byte alignment
-		memcpy((void*) key64, key, len);
-		key8 = (uint8_t*) key64;
-	}
 
 	uint32_t seed = self->seed;
 	uint32_t hash = cc_mumurhash3(seed, len, key8);
-	int      idx  = CC_MAP_IDX(self, hash);
 
-	cc_mapIter_t* miter = self->buckets[idx];
-	while(miter)
-	{
-		cc_mapNode_t* node;
-		node = (cc_mapNode_t*)
-		       cc_list_peekIter(miter);
-		if(CC_MAP_IDX(self, node->hash) != idx)
-		{
-			return NULL;
-		}
+	return cc_map_findHash(self, hash, len, key8);
+}
 
-		int cmp = cc_mapNode_cmp(node, hash, len, key8);
-		if(cmp == 0)
-		{
-			return miter;
-		}
-		else if(cmp > 0)
-		{
-			return NULL;
-		}
+cc_mapIter_t*
+cc_map_findk(const cc_map_t* self, const cc_mapKey_t* key)
+{
+	ASSERT(self);
+	ASSERT(key);
 
-		miter = cc_list_next(miter);
+	int            len;
+	const uint8_t* key8;
+	key8 = cc_mapKey_bytes(key, &len);
+
+	// rehash keys which were hashed with another seed
+	uint32_t hash = key->hash;
+	if(key->seed != self->seed)
+	{
+		hash = cc_mumurhash3(self->seed, len, key8);
 	}
 
-	return NULL;
+	return cc_map_findHash(self, hash, len, key8);
 }
 
 cc_mapIter_t*
@@ -666,14 +1210,24 @@ cc_map_findf(const cc_map_t* self, const char* fmt, ...)
 	ASSERT(self);
 	ASSERT(fmt);
 
-	char key[CC_MAP_KEYLEN];
+	int     len;
+	char    buf[CC_MAP_KEYLEN];
+	char*   key;
 	va_list argptr;
 	va_start(argptr, fmt);
-	vsnprintf(key, CC_MAP_KEYLEN, fmt, argptr);
+	key = cc_map_format(self, buf, &len, fmt, argptr);
 	va_end(argptr);
 
-	int len = strlen(key) + 1;
-	return cc_map_findp(self, len, (const void*) key);
+	if(key == NULL)
+	{
+		return NULL;
+	}
+
+	cc_mapIter_t* miter;
+	miter = cc_map_findp(self, len, (const void*) key);
+	cc_map_formatFree(self, buf, key);
+
+	return miter;
 }
 
 cc_mapIter_t*
@@ -684,79 +1238,40 @@ cc_map_addp(cc_map_t* self, const void* val,
 	ASSERT(self);
 	ASSERT(key);
 
-	// 8-byte aligned temp buffer (if needed)
-	uint64_t key64[CC_MAP_KEYLEN/8];
-
 	const uint8_t* key8 = (const uint8_t*) key;
-	if(len > CC_MAP_KEYLEN)
-	{
-		return NULL;
-	}
-	else if(len == 0)
+	if(len == 0)
 	{
 		// pointer itself is the key
 		len  = sizeof(void*);
 		key8 = (uint8_t*) &key;
 	}
-	else if((((uintptr_t) key) % 8) != 0)
-	{
-		// force 8-byte alignment
-		memcpy((void*) key64, key, len);
-		key8 = (uint8_t*) key64;
-	}
 
 	uint32_t seed = self->seed;
 	uint32_t hash = cc_mumurhash3(seed, len, key8);
-	int      idx  = CC_MAP_IDX(self, hash);
 
-	// add node to existing bucket
-	cc_mapIter_t* miter = self->buckets[idx];
-	if(miter)
-	{
-		while(miter)
-		{
-			cc_mapNode_t* node;
-			node = (cc_mapNode_t*) cc_list_peekIter(miter);
-			if(CC_MAP_IDX(self, node->hash) != idx)
-			{
-				return cc_map_addAt(self, miter, hash, idx,
-				                    val, len, key8);
-			}
-
-			int cmp = cc_mapNode_cmp(node, hash, len, key8);
-			if(cmp == 0)
-			{
-				return NULL;
-			}
-			else if(cmp > 0)
-			{
-				return cc_map_addAt(self, miter, hash, idx,
-				                    val, len, key8);
-			}
+	return cc_map_addHash(self, val, hash, len, key8);
+}
 
-			miter = cc_list_next(miter);
-		}
+cc_mapIter_t*
+cc_map_addk(cc_map_t* self, const void* val,
+            const cc_mapKey_t* key)
+{
+	// val may be NULL
+	ASSERT(self);
+	ASSERT(key);
 
-		return cc_map_addAt(self, miter, hash, idx,
-		                    val, len, key8);
-	}
+	int            len;
+	const uint8_t* key8;
+	key8 = cc_mapKey_bytes(key, &len);
 
-	// add node to an empty bucket
-	// find insert position from next used bucket
-	int i;
-	for(i = idx + 1; i < self->capacity; ++i)
+	// rehash keys which were hashed with another seed
+	uint32_t hash = key->hash;
+	if(key->seed != self->seed)
 	{
-		miter = self->buckets[i];
-		if(miter)
-		{
-			return cc_map_addAt(self, miter, hash, idx,
-			                    val, len, key8);
-		}
+		hash = cc_mumurhash3(self->seed, len, key8);
 	}
 
-	miter = NULL;
-	return cc_map_addAt(self, miter, hash, idx,
-	                    val, len, key8);
+	return cc_map_addHash(self, val, hash, len, key8);
 }
 
 cc_mapIter_t*
@@ -779,14 +1294,24 @@ cc_map_addf(cc_map_t* self,
 	ASSERT(self);
 	ASSERT(fmt);
 
-	char key[CC_MAP_KEYLEN];
+	int     len;
+	char    buf[CC_MAP_KEYLEN];
+	char*   key;
 	va_list argptr;
 	va_start(argptr, fmt);
-	vsnprintf(key, CC_MAP_KEYLEN, fmt, argptr);
+	key = cc_map_format(self, buf, &len, fmt, argptr);
 	va_end(argptr);
 
-	int len = strlen(key) + 1;
-	return cc_map_addp(self, val, len, (const void*) key);
+	if(key == NULL)
+	{
+		return NULL;
+	}
+
+	cc_mapIter_t* miter;
+	miter = cc_map_addp(self, val, len, (const void*) key);
+	cc_map_formatFree(self, buf, key);
+
+	return miter;
 }
 
 const void*
@@ -806,9 +1331,12 @@ cc_map_remove(cc_map_t* self, cc_mapIter_t** _miter)
 	val   = node->val;
 
 	// update bucket pointer
-	int idx = CC_MAP_IDX(self, node->hash);
-	if(self->buckets[idx] == miter)
+	uint32_t        elements;
+	cc_listIter_t** bucket;
+	bucket = cc_map_bucket(self, node->hash, &elements);
+	if(*bucket == miter)
 	{
+		uint32_t       idx  = node->hash/elements;
 		cc_listIter_t* next = cc_list_next(miter);
 		if(next)
 		{
@@ -816,17 +1344,20 @@ cc_map_remove(cc_map_t* self, cc_mapIter_t** _miter)
 			cc_mapNode_t* tmp;
 			tmp = (cc_mapNode_t*)
 			      cc_list_peekIter(next);
-			if(CC_MAP_IDX(self, tmp->hash) != idx)
+			if((tmp->hash/elements) != idx)
 			{
 				next = NULL;
 			}
 		}
-		self->buckets[idx] = next;
+		*bucket = next;
 	}
 
 	// update nodes/miter
 	cc_list_remove(self->nodes, _miter);
 	cc_mapNode_delete(&node, self);
 
+	cc_map_splitStep(self, CC_MAP_SPLIT_STEP);
+	cc_map_autoShrink(self);
+
 	return val;
 }
@@ -30,6 +30,19 @@
 
 typedef cc_listIter_t cc_mapIter_t;
 
+// the mapKey caches the hash of a key for repeated lookups
+// and may be used with any map which shares the seed of
+// the map used to initialize the mapKey (otherwise the key
+// is hashed again) while the key must remain valid for the
+// lifetime of the mapKey
+typedef struct
+{
+	uint32_t    seed;
+	uint32_t    hash;
+	int         len;
+	const void* key;
+} cc_mapKey_t;
+
 typedef struct
 {
 	int      flags;
@@ -37,15 +50,52 @@ typedef struct
 
 	// buckets
 	int             capacity;
+	int             reserve;
 	int             elements;
 	cc_listIter_t** buckets;
 
+	// incremental resize
+	// the old buckets [0, split) have been split into the
+	// buckets and the old buckets are released afterwards
+	int             split;
+	cc_listIter_t** buckets1;
+
 	// nodes
 	size_t     nodes_size;
 	cc_list_t* nodes;
+
+	// optional arena
+	cc_arena_t* arena;
 } cc_map_t;
 
+int           cc_mapKey_initp(cc_mapKey_t* self,
+                              const cc_map_t* map,
+                              int len, const void* key);
+int           cc_mapKey_init(cc_mapKey_t* self,
+                             const cc_map_t* map,
+                             const char* key);
 cc_map_t*     cc_map_new(void);
+cc_map_t*     cc_map_newCapacity(int capacity);
+cc_map_t*     cc_map_newArena(cc_arena_t* arena);
+
+// the capacity is the number of keys which may be added
+// before the buckets are resized and removing keys shrinks
+// the buckets automatically but not below the capacity
+// requested by cc_map_newCapacity/cc_map_reserve
+int           cc_map_reserve(cc_map_t* self, int capacity);
+void          cc_map_shrink(cc_map_t* self);
+
+// maps which share a seed may share mapKeys
+uint32_t      cc_map_seed(const cc_map_t* self);
+void          cc_map_setSeed(cc_map_t* self, uint32_t seed);
+
+// cc_map_incremental spreads the bucket split of a resize
+// over the following add/remove calls rather than
+// splitting every bucket in the add which crossed the
+// capacity and incremental maps are not shrunk
+// automatically (see cc_map_shrink)
+void          cc_map_incremental(cc_map_t* self,
+                                 int incremental);
 void          cc_map_delete(cc_map_t** _self);
 void          cc_map_discard(cc_map_t* self);
 int           cc_map_size(const cc_map_t* self);
@@ -62,6 +112,8 @@ cc_mapIter_t* cc_map_find(const cc_map_t* self,
                          const char* key);
 cc_mapIter_t* cc_map_findf(const cc_map_t* self,
                            const char* fmt, ...);
+cc_mapIter_t* cc_map_findk(const cc_map_t* self,
+                           const cc_mapKey_t* key);
 cc_mapIter_t* cc_map_addp(cc_map_t* self,
                           const void* val,
                           int len,
@@ -72,6 +124,9 @@ cc_mapIter_t* cc_map_add(cc_map_t* self,
 cc_mapIter_t* cc_map_addf(cc_map_t* self,
                           const void* val,
                           const char* fmt, ...);
+cc_mapIter_t* cc_map_addk(cc_map_t* self,
+                          const void* val,
+                          const cc_mapKey_t* key);
 const void*   cc_map_remove(cc_map_t* self,
                             cc_mapIter_t** _miter);
 
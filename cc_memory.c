@@ -21,509 +21,1502 @@
  *
  */
 
+#ifdef __linux__
+	#ifndef _GNU_SOURCE
+		#define _GNU_SOURCE
+	#endif
+	#define CC_MEMORY_MMAP
+#endif
+
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 
+#ifdef CC_MEMORY_MMAP
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
 #define LOG_TAG "cc"
 #include "cc_log.h"
 #include "cc_memory.h"
+#include "cc_timestamp.h"
 
 // The sizeof(cc_memory_t) needs to match the alignment
 // requirements of the platform. However there doesn't seem
 // to be a good platform independent technique to determine
-// this information.
+// this information. Two words are used which matches the
+// malloc alignment on both 32-bit and 64-bit platforms.
 typedef struct
 {
 	size_t size;
+	size_t flags;
 } cc_memory_t;
 
-pthread_mutex_t memory_mutex = PTHREAD_MUTEX_INITIALIZER;
-size_t          memory_count = 0;
-size_t          memory_size  = 0;
-
-#ifdef MEMORY_DEBUG
-
-#include <stdio.h>
-#include <string.h>
-#include "cc_map.h"
-
-/***********************************************************
-* protected                                                *
-***********************************************************/
-
-extern cc_map_t* cc_map_newCMalloc(void);
-
-/***********************************************************
-* private                                                  *
-***********************************************************/
-
-#define CC_MEMORY_NAMELEN 64
+#define CC_MEMORY_FLAG_SAMPLED 1
+
+// Aligned blocks are allocated with the header immediately
+// preceding the returned pointer so that the header may be
+// found in the same manner as unaligned blocks. The header
+// is padded to the alignment and the log2 of the padding is
+// stored in the flags to recover the base pointer.
+#define CC_MEMORY_FLAG_ALIGN_SHIFT 8
+#define CC_MEMORY_FLAG_ALIGN_MASK  0xFF00
+
+// Large blocks are mapped directly so that growing them
+// remaps the pages rather than copying the contents. The
+// header is placed at the start of the mapping and the
+// mapping length is derived from the block size.
+#define CC_MEMORY_FLAG_MMAP 2
+
+#define CC_MEMORY_MMAP_THRESHOLD (1024*1024)
+
+// Tagged blocks store the tag in the header flags so that
+// the tag statistics may be updated by cc_realloc/cc_free.
+// The tag size/count are accumulated in the memory shards
+// (see below) while the peak and budget are shared by all
+// threads. The tag peak is updated at the same granularity
+// as the memory peak and the tag size is only summed on
+// each allocation when a budget has been set.
+#define CC_MEMORY_FLAG_TAG_SHIFT 16
+#define CC_MEMORY_FLAG_TAG_MASK  0xFF0000
 
 typedef struct
 {
-	char      name[CC_MEMORY_NAMELEN];
-	cc_map_t* map_pinfo_ref;
-	size_t    size;
-} cc_ator_t;
+	_Alignas(64) atomic_size_t peak;
+	atomic_size_t              budget;
+	atomic_int                 over;
+	cc_memtag_budgetFn         budget_fn;
+	void*                      budget_priv;
+} cc_memtag_t;
+
+static cc_memtag_t     memory_tags[CC_MEMTAG_COUNT];
+static pthread_mutex_t memory_tag_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// The memory count/size are accumulated in shards so that
+// threads which allocate concurrently do not contend on a
+// single lock or cache line. Each thread is assigned a shard
+// on its first allocation and the shards are summed when the
+// totals are queried. Note that a block may be freed by a
+// different thread than the one which allocated it so the
+// shard values may individually wrap around however the
+// unsigned sum is still exact.
+#define CC_MEMORY_SHARDS 16
+
+// The statistics are accumulated in the same shards. The
+// histogram counts allocations by the bit length of the
+// size (e.g. bucket n counts sizes less than 2^n). The peak
+// size is updated by a thread after it allocates roughly
+// CC_MEMORY_PEAK_STEP bytes so the peak may be under
+// estimated by up to the step size per thread.
+#define CC_MEMORY_PEAK_STEP (64*1024)
 
 typedef struct
 {
-	cc_ator_t* ator_ref;
-	void*      ptr;
-	size_t     size;
-} cc_pinfo_t;
-
-typedef struct
+	_Alignas(64) atomic_size_t count;
+	atomic_size_t              size;
+	atomic_uint_fast64_t       alloc_count;
+	atomic_uint_fast64_t       free_count;
+	atomic_uint_fast64_t       realloc_count;
+	atomic_uint_fast64_t       realloc_grow;
+	atomic_uint_fast64_t       realloc_grow_size;
+	atomic_uint_fast64_t       realloc_shrink;
+	atomic_uint_fast64_t       realloc_shrink_size;
+	atomic_uint_fast64_t       histogram[CC_MEMSTATS_BUCKETS];
+
+	// tag statistics
+	atomic_size_t        tag_size[CC_MEMTAG_COUNT];
+	atomic_size_t        tag_count[CC_MEMTAG_COUNT];
+	atomic_uint_fast64_t tag_alloc_count[CC_MEMTAG_COUNT];
+} cc_memoryShard_t;
+
+static cc_memoryShard_t memory_shards[CC_MEMORY_SHARDS];
+static atomic_uint      memory_shard_next = 0;
+
+static _Thread_local cc_memoryShard_t* memory_shard = NULL;
+
+static atomic_size_t        memory_peak = 0;
+static _Thread_local size_t memory_grow = 0;
+
+static _Thread_local size_t memory_tag_grow[CC_MEMTAG_COUNT];
+
+static cc_memoryShard_t* cc_memory_shard(void)
 {
-	cc_map_t* map_ator;
-	cc_map_t* map_pinfo;
-} cc_meminfo_t;
-
-cc_meminfo_t* memory_meminfo = NULL;
+	if(memory_shard == NULL)
+	{
+		unsigned int idx;
+		idx = atomic_fetch_add_explicit(&memory_shard_next, 1,
+		                                memory_order_relaxed);
+		memory_shard = &memory_shards[idx%CC_MEMORY_SHARDS];
+	}
 
-/***********************************************************
-* private - cc_ator                                        *
-***********************************************************/
+	return memory_shard;
+}
 
-static cc_ator_t*
-cc_ator_new(const char* name)
+static int cc_memory_bucket(size_t size)
 {
-	ASSERT(name);
-
-	cc_ator_t* self;
-	self = (cc_ator_t*) malloc(sizeof(cc_ator_t));
-	if(self == NULL)
+	int n = 0;
+	while(size)
 	{
-		LOGE("malloc failed");
-		return NULL;
+		size >>= 1;
+		++n;
 	}
 
-	snprintf(self->name, CC_MEMORY_NAMELEN, "%s", name);
-
-	self->map_pinfo_ref = cc_map_newCMalloc();
-	if(self->map_pinfo_ref == NULL)
+	if(n >= CC_MEMSTATS_BUCKETS)
 	{
-		goto fail_map_pinfo_ref;
+		n = CC_MEMSTATS_BUCKETS - 1;
 	}
 
-	self->size = 0;
-
-	// success
-	return self;
-
-	// failure
-	fail_map_pinfo_ref:
-		free(self);
-	return NULL;
+	return n;
 }
 
-static void cc_ator_delete(cc_ator_t** _self)
+static void cc_memory_peak(void)
 {
-	ASSERT(_self);
-
-	cc_ator_t* self = *_self;
-	if(self)
+	size_t size = cc_memsize();
+	size_t peak = atomic_load_explicit(&memory_peak,
+	                                   memory_order_relaxed);
+	while(size > peak)
 	{
-		cc_map_discard(self->map_pinfo_ref);
-		cc_map_delete(&self->map_pinfo_ref);
-		free(self);
-		*_self = NULL;
+		if(atomic_compare_exchange_weak_explicit(&memory_peak,
+		                                         &peak, size,
+		                                         memory_order_relaxed,
+		                                         memory_order_relaxed))
+		{
+			break;
+		}
 	}
 }
 
-static int
-cc_ator_add(cc_ator_t* self, cc_pinfo_t* pinfo_ref)
+static void cc_memory_grow(size_t size)
 {
-	ASSERT(self);
-	ASSERT(pinfo_ref);
-
-	if(cc_map_addp(self->map_pinfo_ref,
-	               (const void*) pinfo_ref,
-	               0, pinfo_ref->ptr) == NULL)
+	memory_grow += size;
+	if(memory_grow >= CC_MEMORY_PEAK_STEP)
 	{
-		return 0;
+		memory_grow = 0;
+		cc_memory_peak();
 	}
-	self->size += pinfo_ref->size;
-	return 1;
 }
 
-static void
-cc_ator_rem(cc_ator_t* self, cc_pinfo_t* pinfo_ref)
+static void cc_memory_inc(size_t size)
 {
-	ASSERT(self);
-	ASSERT(pinfo_ref);
-
-	cc_mapIter_t* miter;
-	miter = cc_map_findp(self->map_pinfo_ref, 0,
-	                     pinfo_ref->ptr);
-	if(miter)
-	{
-		self->size -= pinfo_ref->size;
-		cc_map_remove(self->map_pinfo_ref, &miter);
-	}
+	cc_memoryShard_t* shard = cc_memory_shard();
+	atomic_fetch_add_explicit(&shard->count, 1,
+	                          memory_order_relaxed);
+	atomic_fetch_add_explicit(&shard->size, size,
+	                          memory_order_relaxed);
+	atomic_fetch_add_explicit(&shard->alloc_count, 1,
+	                          memory_order_relaxed);
+	atomic_fetch_add_explicit(&shard->histogram[cc_memory_bucket(size)],
+	                          1, memory_order_relaxed);
+	cc_memory_grow(size);
 }
 
-/***********************************************************
-* private - cc_pinfo                                       *
-***********************************************************/
+static void cc_memory_dec(size_t size)
+{
+	cc_memoryShard_t* shard = cc_memory_shard();
+	atomic_fetch_sub_explicit(&shard->count, 1,
+	                          memory_order_relaxed);
+	atomic_fetch_sub_explicit(&shard->size, size,
+	                          memory_order_relaxed);
+	atomic_fetch_add_explicit(&shard->free_count, 1,
+	                          memory_order_relaxed);
+}
 
-static cc_pinfo_t*
-cc_pinfo_new(cc_ator_t* ator_ref, void* ptr, size_t size)
+static void* cc_memory_base(cc_memory_t* mem)
 {
-	ASSERT(ator_ref);
-	ASSERT(ptr);
+	ASSERT(mem);
 
-	cc_pinfo_t* self;
-	self = (cc_pinfo_t*) malloc(sizeof(cc_pinfo_t));
-	if(self == NULL)
+	size_t shift = (mem->flags & CC_MEMORY_FLAG_ALIGN_MASK) >>
+	               CC_MEMORY_FLAG_ALIGN_SHIFT;
+	if(shift)
 	{
-		LOGE("malloc failed");
-		return NULL;
+		return (void*) mem + sizeof(cc_memory_t) -
+		       ((size_t) 1 << shift);
 	}
 
-	self->ator_ref = ator_ref;
-	self->ptr      = ptr;
-	self->size     = size;
-	return self;
+	return (void*) mem;
 }
 
-static void cc_pinfo_delete(cc_pinfo_t** _self)
-{
-	ASSERT(_self);
+#ifdef CC_MEMORY_MMAP
 
-	cc_pinfo_t* self = *_self;
-	if(self)
-	{
-		free(self);
-		*_self = NULL;
-	}
-}
+static atomic_size_t memory_mmap_threshold = CC_MEMORY_MMAP_THRESHOLD;
+static atomic_int    memory_mmap_hugepage  = 0;
 
-/***********************************************************
-* private - cc_meminfo                                     *
-***********************************************************/
+static int cc_memory_usemmap(size_t size)
+{
+	size_t threshold;
+	threshold = atomic_load_explicit(&memory_mmap_threshold,
+	                                 memory_order_relaxed);
+	return threshold && (size >= threshold);
+}
 
-static cc_meminfo_t* cc_meminfo_init(void)
+static size_t cc_memory_mmaplen(size_t size)
 {
-	if(memory_meminfo)
-	{
-		return memory_meminfo;
-	}
+	size_t page = (size_t) sysconf(_SC_PAGESIZE);
+	size_t len  = size + sizeof(cc_memory_t);
+	return (len + page - 1) & ~(page - 1);
+}
 
-	memory_meminfo = (cc_meminfo_t*)
-	                 malloc(sizeof(cc_meminfo_t));
-	if(memory_meminfo == NULL)
-	{
-		LOGE("malloc failed");
-		return NULL;
-	}
+static void cc_memory_madvise(void* addr, size_t len)
+{
+	ASSERT(addr);
 
-	memory_meminfo->map_ator = cc_map_newCMalloc();
-	if(memory_meminfo->map_ator == NULL)
+	#ifdef MADV_HUGEPAGE
+	if(atomic_load_explicit(&memory_mmap_hugepage,
+	                        memory_order_relaxed))
 	{
-		goto fail_map_ator;
+		// the hint is optional so errors are ignored
+		madvise(addr, len, MADV_HUGEPAGE);
 	}
+	#endif
+}
 
-	memory_meminfo->map_pinfo = cc_map_newCMalloc();
-	if(memory_meminfo->map_pinfo == NULL)
+static cc_memory_t* cc_memory_mmap(size_t size)
+{
+	size_t len  = cc_memory_mmaplen(size);
+	void*  addr = mmap(NULL, len, PROT_READ | PROT_WRITE,
+	                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(addr == MAP_FAILED)
 	{
-		goto fail_map_pinfo;
+		LOGE("mmap failed");
+		return NULL;
 	}
+	cc_memory_madvise(addr, len);
 
-	// success
-	return memory_meminfo;
-
-	// failure
-	fail_map_pinfo:
-		cc_map_delete(&memory_meminfo->map_ator);
-	fail_map_ator:
-		free(memory_meminfo);
-		memory_meminfo = NULL;
-	return NULL;
+	// mapped pages are zero filled
+	cc_memory_t* mem = (cc_memory_t*) addr;
+	mem->size  = size;
+	mem->flags = CC_MEMORY_FLAG_MMAP;
+	return mem;
 }
 
-static void
-cc_meminfo_add(cc_meminfo_t* self,
-               const char* func, int line,
-               void* ptr, size_t size)
+static cc_memory_t* cc_memory_mremap(cc_memory_t* mem, size_t size)
 {
-	ASSERT(self);
-	ASSERT(func);
-	ASSERT(ptr);
+	ASSERT(mem);
 
-	char name[CC_MEMORY_NAMELEN];
-	snprintf(name, CC_MEMORY_NAMELEN, "%s@%i", func, line);
+	size_t len1 = cc_memory_mmaplen(mem->size);
+	size_t len2 = cc_memory_mmaplen(size);
 
-	// get ator
-	cc_ator_t*    ator;
-	cc_mapIter_t* miter;
-	miter = cc_map_find(self->map_ator, name);
-	if(miter == NULL)
+	void* addr = (void*) mem;
+	if(len1 != len2)
 	{
-		ator = cc_ator_new(name);
-		if(ator == NULL)
+		addr = mremap(addr, len1, len2, MREMAP_MAYMOVE);
+		if(addr == MAP_FAILED)
 		{
-			return;
+			LOGE("mremap failed");
+			return NULL;
 		}
 
-		// add ator
-		if(cc_map_add(self->map_ator, (const void*) ator,
-		              name) == NULL)
+		if(len2 > len1)
 		{
-			cc_ator_delete(&ator);
-			return;
+			cc_memory_madvise(addr, len2);
 		}
 	}
-	else
-	{
-		ator = (cc_ator_t*) cc_map_val(miter);
-	}
 
-	// create pinfo
-	cc_pinfo_t* pinfo = cc_pinfo_new(ator, ptr, size);
-	if(pinfo == NULL)
-	{
-		return;
-	}
+	mem = (cc_memory_t*) addr;
+	mem->size = size;
+	return mem;
+}
 
-	// add pinfo to meminfo
-	miter = cc_map_addp(self->map_pinfo, (const void*) pinfo,
-	                    0, pinfo->ptr);
-	if(miter == NULL)
-	{
-		goto fail_map_add;
-	}
+static void cc_memory_munmap(cc_memory_t* mem)
+{
+	ASSERT(mem);
 
-	// add pinfo to ator
-	if(cc_ator_add(ator, pinfo) == 0)
-	{
-		goto fail_ator_add;
-	}
+	munmap((void*) mem, cc_memory_mmaplen(mem->size));
+}
 
-	// success
-	return;
+#endif
 
-	// failure
-	fail_ator_add:
-		cc_map_remove(self->map_pinfo, &miter);
-	fail_map_add:
-		cc_pinfo_delete(&pinfo);
+static int cc_memory_tag(cc_memory_t* mem)
+{
+	ASSERT(mem);
+
+	return (int) ((mem->flags & CC_MEMORY_FLAG_TAG_MASK) >>
+	              CC_MEMORY_FLAG_TAG_SHIFT);
 }
 
-static void
-cc_meminfo_rem(cc_meminfo_t* self, const char* func,
-               int line, void* ptr)
+static size_t cc_memtag_size(int tag)
 {
-	ASSERT(self);
-	ASSERT(func);
-	ASSERT(ptr);
+	size_t size = 0;
 
-	cc_pinfo_t*   pinfo;
-	cc_mapIter_t* miter;
-	miter = cc_map_findp(self->map_pinfo, 0, ptr);
-	if(miter == NULL)
+	int i;
+	for(i = 0; i < CC_MEMORY_SHARDS; ++i)
 	{
-		LOGW("invalid %s@%i ptr=%p", func, line, ptr);
-		return;
+		size += atomic_load_explicit(&memory_shards[i].tag_size[tag],
+		                             memory_order_relaxed);
 	}
-	pinfo = (cc_pinfo_t*) cc_map_val(miter);
 
-	cc_ator_rem(pinfo->ator_ref, pinfo);
-	cc_map_remove(self->map_pinfo, &miter);
-	cc_pinfo_delete(&pinfo);
+	return size;
 }
 
-static int
-cc_meminfo_memcheckptr(cc_meminfo_t* self, const char* func,
-                       int line, void* ptr)
+static void cc_memtag_peak(int tag, size_t size)
 {
-	ASSERT(self);
-	ASSERT(func);
-	ASSERT(ptr);
+	cc_memtag_t* self = &memory_tags[tag];
 
-	cc_mapIter_t* miter;
-	miter = cc_map_findp(self->map_pinfo, 0, ptr);
-	if(miter == NULL)
+	size_t peak = atomic_load_explicit(&self->peak,
+	                                   memory_order_relaxed);
+	while(size > peak)
 	{
-		LOGE("invalid %s@%i ptr=%p", func, line, ptr);
-		return 0;
+		if(atomic_compare_exchange_weak_explicit(&self->peak,
+		                                         &peak, size,
+		                                         memory_order_relaxed,
+		                                         memory_order_relaxed))
+		{
+			break;
+		}
 	}
-
-	return 1;
 }
 
-static void cc_meminfo_meminfo(cc_meminfo_t* self)
+static void cc_memtag_grow(int tag, size_t size)
 {
-	ASSERT(self);
+	cc_memtag_t*      self  = &memory_tags[tag];
+	cc_memoryShard_t* shard = cc_memory_shard();
+	atomic_fetch_add_explicit(&shard->tag_size[tag], size,
+	                          memory_order_relaxed);
 
-	LOGI("cnt_ator=%i, cnt_pinfo=%i",
-	     cc_map_size(self->map_ator),
-	     cc_map_size(self->map_pinfo));
+	size_t budget = atomic_load_explicit(&self->budget,
+	                                     memory_order_relaxed);
 
-	cc_mapIter_t* miter = cc_map_head(self->map_ator);
-	while(miter)
+	memory_tag_grow[tag] += size;
+	if((memory_tag_grow[tag] < CC_MEMORY_PEAK_STEP) &&
+	   (budget == 0))
 	{
-		cc_ator_t* ator = (cc_ator_t*) cc_map_val(miter);
+		return;
+	}
+	memory_tag_grow[tag] = 0;
 
-		LOGI("name=%s, cnt_pinfo=%i, size=%" PRIu64,
-		     ator->name, cc_map_size(ator->map_pinfo_ref),
-		     (uint64_t) ator->size);
+	size_t size2 = cc_memtag_size(tag);
+	cc_memtag_peak(tag, size2);
 
-		miter = cc_map_next(miter);
+	// the budget callback is edge triggered and is rearmed
+	// once the size drops back under the budget
+	if(budget && (size2 > budget) &&
+	   (atomic_load_explicit(&self->over,
+	                         memory_order_relaxed) == 0) &&
+	   (atomic_exchange(&self->over, 1) == 0))
+	{
+		pthread_mutex_lock(&memory_tag_mutex);
+		cc_memtag_budgetFn budget_fn = self->budget_fn;
+		void*              priv      = self->budget_priv;
+		pthread_mutex_unlock(&memory_tag_mutex);
+
+		if(budget_fn)
+		{
+			(*budget_fn)(priv, tag, size2, budget);
+		}
 	}
 }
 
-/***********************************************************
-* private - cc_memory                                      *
-***********************************************************/
-
-static void
-cc_memory_add(const char* func, int line, void* ptr,
-              size_t size)
+static void cc_memtag_shrink(int tag, size_t size)
 {
-	ASSERT(func);
-
-	// ignore NULL
-	if(ptr == NULL)
+	cc_memtag_t*      self  = &memory_tags[tag];
+	cc_memoryShard_t* shard = cc_memory_shard();
+	atomic_fetch_sub_explicit(&shard->tag_size[tag], size,
+	                          memory_order_relaxed);
+
+	size_t budget = atomic_load_explicit(&self->budget,
+	                                     memory_order_relaxed);
+	if(budget &&
+	   atomic_load_explicit(&self->over, memory_order_relaxed) &&
+	   (cc_memtag_size(tag) <= budget))
 	{
-		return;
+		atomic_store(&self->over, 0);
 	}
+}
 
-	pthread_mutex_lock(&memory_mutex);
-
-	if(cc_meminfo_init() == NULL)
+static void cc_memtag_resize(int tag, size_t size1, size_t size2)
+{
+	if(tag == CC_MEMTAG_NONE)
 	{
-		pthread_mutex_unlock(&memory_mutex);
 		return;
 	}
 
-	cc_meminfo_add(memory_meminfo, func, line, ptr, size);
-
-	pthread_mutex_unlock(&memory_mutex);
+	if(size2 > size1)
+	{
+		cc_memtag_grow(tag, size2 - size1);
+	}
+	else if(size2 < size1)
+	{
+		cc_memtag_shrink(tag, size1 - size2);
+	}
 }
 
-static void
-cc_memory_rem(const char* func, int line, void* ptr)
+static void cc_memory_restat(size_t size1, size_t size2)
 {
-	ASSERT(func);
+	cc_memoryShard_t* shard = cc_memory_shard();
+	atomic_fetch_add_explicit(&shard->realloc_count, 1,
+	                          memory_order_relaxed);
+	if(size2 > size1)
+	{
+		atomic_fetch_add_explicit(&shard->realloc_grow, 1,
+		                          memory_order_relaxed);
+		atomic_fetch_add_explicit(&shard->realloc_grow_size,
+		                          size2 - size1,
+		                          memory_order_relaxed);
+	}
+	else if(size2 < size1)
+	{
+		atomic_fetch_add_explicit(&shard->realloc_shrink, 1,
+		                          memory_order_relaxed);
+		atomic_fetch_add_explicit(&shard->realloc_shrink_size,
+		                          size1 - size2,
+		                          memory_order_relaxed);
+	}
+}
 
-	// ignore NULL
-	if(ptr == NULL)
+static void cc_memory_resize(size_t size1, size_t size2)
+{
+	cc_memoryShard_t* shard = cc_memory_shard();
+	if(size2 >= size1)
 	{
-		return;
+		atomic_fetch_add_explicit(&shard->size, size2 - size1,
+		                          memory_order_relaxed);
+		cc_memory_grow(size2 - size1);
+	}
+	else
+	{
+		atomic_fetch_sub_explicit(&shard->size, size1 - size2,
+		                          memory_order_relaxed);
 	}
+}
 
-	pthread_mutex_lock(&memory_mutex);
+// the raw alloc/release functions do not update the memory
+// statistics so that cc_realloc may move a block without
+// counting an extra alloc/free
 
-	if(cc_meminfo_init() == NULL)
+static cc_memory_t* cc_memory_alloc(size_t size)
+{
+	cc_memory_t* mem;
+	#ifdef CC_MEMORY_MMAP
+	if(cc_memory_usemmap(size))
 	{
-		pthread_mutex_unlock(&memory_mutex);
-		return;
+		mem = cc_memory_mmap(size);
+	}
+	else
+	#endif
+	{
+		mem = (cc_memory_t*)
+		      malloc(size + sizeof(cc_memory_t));
+		if(mem)
+		{
+			mem->flags = 0;
+		}
 	}
 
-	cc_meminfo_rem(memory_meminfo, func, line, ptr);
+	if(mem == NULL)
+	{
+		return NULL;
+	}
+	mem->size = size;
 
-	pthread_mutex_unlock(&memory_mutex);
+	return mem;
 }
 
-static int
-cc_memory_memcheckptr(const char* func, int line, void* ptr)
+static cc_memory_t*
+cc_memory_allocAligned(size_t alignment, size_t size)
 {
-	ASSERT(func);
+	// alignment must be a power of two
+	ASSERT(alignment);
+	ASSERT((alignment & (alignment - 1)) == 0);
 
-	// ignore NULL
-	if(ptr == NULL)
+	size_t pad = sizeof(cc_memory_t);
+	if(alignment > pad)
 	{
-		return 1;
+		pad = alignment;
 	}
 
-	pthread_mutex_lock(&memory_mutex);
-
-	if(cc_meminfo_init() == NULL)
+	size_t shift = 0;
+	while(((size_t) 1 << shift) < pad)
 	{
-		pthread_mutex_unlock(&memory_mutex);
-		return 0;
+		++shift;
 	}
 
-	int ret = cc_meminfo_memcheckptr(memory_meminfo,
-	                                 func, line, ptr);
+	void* base = NULL;
+	if(posix_memalign(&base, pad, pad + size) != 0)
+	{
+		LOGE("posix_memalign failed");
+		return NULL;
+	}
 
-	pthread_mutex_unlock(&memory_mutex);
+	cc_memory_t* mem;
+	mem = (cc_memory_t*)
+	      (base + pad - sizeof(cc_memory_t));
+	mem->size  = size;
+	mem->flags = shift << CC_MEMORY_FLAG_ALIGN_SHIFT;
 
-	return ret;
+	return mem;
 }
 
-static void cc_memory_meminfo(void)
+static void cc_memory_release(cc_memory_t* mem)
 {
-	pthread_mutex_lock(&memory_mutex);
+	ASSERT(mem);
 
-	if(cc_meminfo_init() == NULL)
+	#ifdef CC_MEMORY_MMAP
+	if(mem->flags & CC_MEMORY_FLAG_MMAP)
 	{
-		pthread_mutex_unlock(&memory_mutex);
+		cc_memory_munmap(mem);
 		return;
 	}
+	#endif
 
-	cc_meminfo_meminfo(memory_meminfo);
-
-	pthread_mutex_unlock(&memory_mutex);
+	free(cc_memory_base(mem));
+}
+
+static void* cc_memory_move(cc_memory_t* mem1, cc_memory_t* mem2)
+{
+	ASSERT(mem1);
+	ASSERT(mem2);
+
+	size_t size1 = mem1->size;
+	size_t size2 = mem2->size;
+
+	memcpy((void*) mem2 + sizeof(cc_memory_t),
+	       (void*) mem1 + sizeof(cc_memory_t),
+	       (size2 < size1) ? size2 : size1);
+
+	// preserve the sampled flag and tag like realloc
+	mem2->flags |= mem1->flags & (CC_MEMORY_FLAG_SAMPLED |
+	                              CC_MEMORY_FLAG_TAG_MASK);
+	cc_memory_release(mem1);
+
+	cc_memory_resize(size1, size2);
+	cc_memtag_resize(cc_memory_tag(mem2), size1, size2);
+	LOGD("mem=%p, size=%i", mem2, (int) mem2->size);
+
+	return (void*) mem2 + sizeof(cc_memory_t);
+}
+
+#ifdef MEMORY_DEBUG
+
+#include <stdio.h>
+#include <string.h>
+#include "cc_map.h"
+#include "cc_ptrmap.h"
+
+/***********************************************************
+* protected                                                *
+***********************************************************/
+
+extern cc_map_t*    cc_map_newCMalloc(void);
+extern cc_ptrmap_t* cc_ptrmap_newCMalloc(void);
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// The pointer table is split into shards by pointer hash
+// where each shard has its own lock so that tracked threads
+// rarely contend. The per call site (ator) statistics are
+// aggregated lazily by cc_meminfo_debug.
+
+#define CC_MEMORY_NAMELEN 64
+
+#define CC_MEMORY_DEBUG_SHARDS 16
+
+typedef struct
+{
+	char   name[CC_MEMORY_NAMELEN];
+	int    count;
+	size_t size;
+} cc_ator_t;
+
+typedef struct
+{
+	const char* func;
+	int         line;
+	void*       ptr;
+	size_t      size;
+} cc_pinfo_t;
+
+typedef struct
+{
+	pthread_mutex_t mutex;
+	cc_ptrmap_t*    map_pinfo;
+} cc_meminfo_t;
+
+#define CC_MEMINFO_SHARD \
+	{ .mutex=PTHREAD_MUTEX_INITIALIZER, .map_pinfo=NULL }
+
+static cc_meminfo_t memory_meminfo[CC_MEMORY_DEBUG_SHARDS] =
+{
+	CC_MEMINFO_SHARD, CC_MEMINFO_SHARD,
+	CC_MEMINFO_SHARD, CC_MEMINFO_SHARD,
+	CC_MEMINFO_SHARD, CC_MEMINFO_SHARD,
+	CC_MEMINFO_SHARD, CC_MEMINFO_SHARD,
+	CC_MEMINFO_SHARD, CC_MEMINFO_SHARD,
+	CC_MEMINFO_SHARD, CC_MEMINFO_SHARD,
+	CC_MEMINFO_SHARD, CC_MEMINFO_SHARD,
+	CC_MEMINFO_SHARD, CC_MEMINFO_SHARD,
+};
+
+/***********************************************************
+* private - cc_ator                                        *
+***********************************************************/
+
+static cc_ator_t* cc_ator_new(const char* name)
+{
+	ASSERT(name);
+
+	cc_ator_t* self;
+	self = (cc_ator_t*) malloc(sizeof(cc_ator_t));
+	if(self == NULL)
+	{
+		LOGE("malloc failed");
+		return NULL;
+	}
+
+	snprintf(self->name, CC_MEMORY_NAMELEN, "%s", name);
+	self->count = 0;
+	self->size  = 0;
+
+	return self;
+}
+
+static void cc_ator_delete(cc_ator_t** _self)
+{
+	ASSERT(_self);
+
+	cc_ator_t* self = *_self;
+	if(self)
+	{
+		free(self);
+		*_self = NULL;
+	}
+}
+
+static int
+cc_ator_add(cc_map_t* map_ator, cc_pinfo_t* pinfo)
+{
+	ASSERT(map_ator);
+	ASSERT(pinfo);
+
+	char name[CC_MEMORY_NAMELEN];
+	snprintf(name, CC_MEMORY_NAMELEN, "%s@%i",
+	         pinfo->func, pinfo->line);
+
+	// get ator
+	cc_ator_t*    ator;
+	cc_mapIter_t* miter;
+	miter = cc_map_find(map_ator, name);
+	if(miter == NULL)
+	{
+		ator = cc_ator_new(name);
+		if(ator == NULL)
+		{
+			return 0;
+		}
+
+		// add ator
+		if(cc_map_add(map_ator, (const void*) ator,
+		              name) == NULL)
+		{
+			cc_ator_delete(&ator);
+			return 0;
+		}
+	}
+	else
+	{
+		ator = (cc_ator_t*) cc_map_val(miter);
+	}
+
+	++ator->count;
+	ator->size += pinfo->size;
+
+	return 1;
+}
+
+/***********************************************************
+* private - cc_pinfo                                       *
+***********************************************************/
+
+static cc_pinfo_t*
+cc_pinfo_new(const char* func, int line, void* ptr,
+             size_t size)
+{
+	ASSERT(func);
+	ASSERT(ptr);
+
+	cc_pinfo_t* self;
+	self = (cc_pinfo_t*) malloc(sizeof(cc_pinfo_t));
+	if(self == NULL)
+	{
+		LOGE("malloc failed");
+		return NULL;
+	}
+
+	// func is a static string from __func__
+	self->func = func;
+	self->line = line;
+	self->ptr  = ptr;
+	self->size = size;
+	return self;
+}
+
+static void cc_pinfo_delete(cc_pinfo_t** _self)
+{
+	ASSERT(_self);
+
+	cc_pinfo_t* self = *_self;
+	if(self)
+	{
+		free(self);
+		*_self = NULL;
+	}
+}
+
+/***********************************************************
+* private - cc_meminfo                                     *
+***********************************************************/
+
+static cc_meminfo_t* cc_meminfo_lock(void* ptr)
+{
+	ASSERT(ptr);
+
+	// ignore the low bits which are fixed by alignment
+	uint32_t h = (uint32_t) (((uintptr_t) ptr) >> 4);
+	h *= 0x9E3779B1;
+
+	cc_meminfo_t* self;
+	self = &memory_meminfo[h >> 28];
+
+	pthread_mutex_lock(&self->mutex);
+
+	if(self->map_pinfo == NULL)
+	{
+		self->map_pinfo = cc_ptrmap_newCMalloc();
+		if(self->map_pinfo == NULL)
+		{
+			pthread_mutex_unlock(&self->mutex);
+			return NULL;
+		}
+	}
+
+	return self;
+}
+
+static void cc_meminfo_unlock(cc_meminfo_t* self)
+{
+	ASSERT(self);
+
+	pthread_mutex_unlock(&self->mutex);
+}
+
+static void
+cc_meminfo_add(cc_meminfo_t* self,
+               const char* func, int line,
+               void* ptr, size_t size)
+{
+	ASSERT(self);
+	ASSERT(func);
+	ASSERT(ptr);
+
+	cc_pinfo_t* pinfo = cc_pinfo_new(func, line, ptr, size);
+	if(pinfo == NULL)
+	{
+		return;
+	}
+
+	if(cc_ptrmap_addp(self->map_pinfo, (const void*) pinfo,
+	                  pinfo->ptr) == NULL)
+	{
+		cc_pinfo_delete(&pinfo);
+	}
+}
+
+static void
+cc_meminfo_rem(cc_meminfo_t* self, const char* func,
+               int line, void* ptr)
+{
+	ASSERT(self);
+	ASSERT(func);
+	ASSERT(ptr);
+
+	cc_pinfo_t*      pinfo;
+	cc_ptrmapIter_t* miter;
+	miter = cc_ptrmap_findp(self->map_pinfo, ptr);
+	if(miter == NULL)
+	{
+		LOGW("invalid %s@%i ptr=%p", func, line, ptr);
+		return;
+	}
+
+	pinfo = (cc_pinfo_t*)
+	        cc_ptrmap_remove(self->map_pinfo, &miter);
+	cc_pinfo_delete(&pinfo);
+}
+
+static int
+cc_meminfo_memcheckptr(cc_meminfo_t* self, const char* func,
+                       int line, void* ptr)
+{
+	ASSERT(self);
+	ASSERT(func);
+	ASSERT(ptr);
+
+	cc_ptrmapIter_t* miter;
+	miter = cc_ptrmap_findp(self->map_pinfo, ptr);
+	if(miter == NULL)
+	{
+		LOGE("invalid %s@%i ptr=%p", func, line, ptr);
+		return 0;
+	}
+
+	return 1;
+}
+
+/***********************************************************
+* private - cc_memory                                      *
+***********************************************************/
+
+static void
+cc_memory_add(const char* func, int line, void* ptr,
+              size_t size)
+{
+	ASSERT(func);
+
+	// ignore NULL
+	if(ptr == NULL)
+	{
+		return;
+	}
+
+	cc_meminfo_t* meminfo = cc_meminfo_lock(ptr);
+	if(meminfo == NULL)
+	{
+		return;
+	}
+
+	cc_meminfo_add(meminfo, func, line, ptr, size);
+
+	cc_meminfo_unlock(meminfo);
+}
+
+static void
+cc_memory_rem(const char* func, int line, void* ptr)
+{
+	ASSERT(func);
+
+	// ignore NULL
+	if(ptr == NULL)
+	{
+		return;
+	}
+
+	cc_meminfo_t* meminfo = cc_meminfo_lock(ptr);
+	if(meminfo == NULL)
+	{
+		return;
+	}
+
+	cc_meminfo_rem(meminfo, func, line, ptr);
+
+	cc_meminfo_unlock(meminfo);
+}
+
+static int
+cc_memory_memcheckptr(const char* func, int line, void* ptr)
+{
+	ASSERT(func);
+
+	// ignore NULL
+	if(ptr == NULL)
+	{
+		return 1;
+	}
+
+	cc_meminfo_t* meminfo = cc_meminfo_lock(ptr);
+	if(meminfo == NULL)
+	{
+		return 0;
+	}
+
+	int ret = cc_meminfo_memcheckptr(meminfo,
+	                                 func, line, ptr);
+
+	cc_meminfo_unlock(meminfo);
+
+	return ret;
+}
+
+static void cc_memory_meminfo(void)
+{
+	// aggregate the ator statistics
+	cc_map_t* map_ator = cc_map_newCMalloc();
+	if(map_ator == NULL)
+	{
+		return;
+	}
+
+	int cnt_pinfo = 0;
+	int i;
+	for(i = 0; i < CC_MEMORY_DEBUG_SHARDS; ++i)
+	{
+		cc_meminfo_t* meminfo = &memory_meminfo[i];
+
+		pthread_mutex_lock(&meminfo->mutex);
+
+		if(meminfo->map_pinfo)
+		{
+			cnt_pinfo += cc_ptrmap_size(meminfo->map_pinfo);
+
+			cc_ptrmapIter_t* miter;
+			miter = cc_ptrmap_head(meminfo->map_pinfo);
+			while(miter)
+			{
+				cc_pinfo_t* pinfo;
+				pinfo = (cc_pinfo_t*) cc_ptrmap_val(miter);
+				cc_ator_add(map_ator, pinfo);
+
+				miter = cc_ptrmap_next(meminfo->map_pinfo,
+				                       miter);
+			}
+		}
+
+		pthread_mutex_unlock(&meminfo->mutex);
+	}
+
+	LOGI("cnt_ator=%i, cnt_pinfo=%i",
+	     cc_map_size(map_ator), cnt_pinfo);
+
+	cc_mapIter_t* miter = cc_map_head(map_ator);
+	while(miter)
+	{
+		cc_ator_t* ator;
+		ator = (cc_ator_t*) cc_map_remove(map_ator, &miter);
+
+		LOGI("name=%s, cnt_pinfo=%i, size=%" PRIu64,
+		     ator->name, ator->count, (uint64_t) ator->size);
+
+		cc_ator_delete(&ator);
+	}
+
+	cc_map_delete(&map_ator);
+}
+
+/***********************************************************
+* public - debug                                           *
+***********************************************************/
+
+void* cc_malloc_debug(const char* func, int line,
+                      size_t size)
+{
+	void* ptr = cc_malloc(size);
+	cc_memory_add(func, line, ptr, size);
+	return ptr;
+}
+
+void* cc_calloc_debug(const char* func, int line,
+                      size_t count, size_t size)
+{
+	void* ptr = cc_calloc(count, size);
+	cc_memory_add(func, line, ptr, count*size);
+	return ptr;
+}
+
+void* cc_realloc_debug(const char* func, int line,
+                       void* ptr, size_t size)
+{
+	size_t size1 = cc_memsizeptr(ptr);
+	cc_memory_rem(func, line, ptr);
+	void* reptr = cc_realloc(ptr, size);
+	if(reptr)
+	{
+		cc_memory_add(func, line, reptr, size);
+	}
+	else
+	{
+		cc_memory_add(func, line, ptr, size1);
+	}
+	return reptr;
+}
+
+void cc_free_debug(const char* func, int line, void* ptr)
+{
+	cc_memory_rem(func, line, ptr);
+	cc_free(ptr);
+}
+
+void* cc_malloc_tag_debug(const char* func, int line,
+                          int tag, size_t size)
+{
+	void* ptr = cc_malloc_tag(tag, size);
+	cc_memory_add(func, line, ptr, size);
+	return ptr;
+}
+
+void* cc_calloc_tag_debug(const char* func, int line,
+                          int tag, size_t count, size_t size)
+{
+	void* ptr = cc_calloc_tag(tag, count, size);
+	cc_memory_add(func, line, ptr, count*size);
+	return ptr;
+}
+
+void* cc_malloc_aligned_debug(const char* func, int line,
+                              size_t alignment, size_t size)
+{
+	void* ptr = cc_malloc_aligned(alignment, size);
+	cc_memory_add(func, line, ptr, size);
+	return ptr;
+}
+
+void cc_free_aligned_debug(const char* func, int line,
+                           void* ptr)
+{
+	cc_memory_rem(func, line, ptr);
+	cc_free_aligned(ptr);
+}
+
+void cc_meminfo_debug(void)
+{
+	cc_meminfo();
+	cc_memory_meminfo();
+}
+
+int cc_memcheckptr_debug(const char* func, int line,
+                         void* ptr)
+{
+	return cc_memory_memcheckptr(func, line, ptr);
+}
+
+#endif // MEMORY_DEBUG
+
+#ifdef MEMORY_PROFILE
+
+#include <math.h>
+#include <stdio.h>
+#include "cc_map.h"
+#include "cc_ptrmap.h"
+
+/***********************************************************
+* protected                                                *
+***********************************************************/
+
+extern cc_map_t*    cc_map_newCMalloc(void);
+extern cc_ptrmap_t* cc_ptrmap_newCMalloc(void);
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// The profiler records roughly one allocation per interval
+// bytes allocated. The distance between samples is drawn
+// from an exponential distribution so that allocation
+// patterns cannot alias with the sampling interval. Each
+// sample is weighted by the inverse of its probability of
+// being sampled to estimate the live bytes per call site.
+
+#define CC_MEMORY_NAMELEN 64
+
+#define CC_MEMORY_PROFILE_INTERVAL (512*1024)
+
+typedef struct
+{
+	char   name[CC_MEMORY_NAMELEN];
+	double count;
+	double size;
+} cc_site_t;
+
+typedef struct
+{
+	cc_site_t* site_ref;
+	double     weight;
+	size_t     size;
+} cc_sample_t;
+
+static pthread_mutex_t profile_mutex = PTHREAD_MUTEX_INITIALIZER;
+static cc_map_t*       profile_map_site   = NULL;
+static cc_ptrmap_t*    profile_map_sample = NULL;
+static atomic_size_t   profile_interval   = CC_MEMORY_PROFILE_INTERVAL;
+
+static _Thread_local size_t   profile_next = 0;
+static _Thread_local uint64_t profile_rng  = 0;
+
+static double cc_memory_random(void)
+{
+	// xorshift64* seeded per thread
+	if(profile_rng == 0)
+	{
+		profile_rng = (uint64_t) (uintptr_t) &profile_rng;
+		profile_rng ^= (uint64_t) random() << 32;
+		profile_rng |= 1;
+	}
+
+	profile_rng ^= profile_rng >> 12;
+	profile_rng ^= profile_rng << 25;
+	profile_rng ^= profile_rng >> 27;
+
+	uint64_t r = profile_rng*0x2545F4914F6CDD1DULL;
+
+	// uniform in (0, 1]
+	return ((double) (r >> 11) + 1.0)/9007199254740992.0;
+}
+
+static size_t cc_memory_nextSample(void)
+{
+	double interval;
+	interval = (double)
+	           atomic_load_explicit(&profile_interval,
+	                                memory_order_relaxed);
+
+	double next = -log(cc_memory_random())*interval;
+	if(next < 1.0)
+	{
+		return 1;
+	}
+
+	return (size_t) next;
+}
+
+static int cc_memory_sample(size_t size)
+{
+	if(profile_next == 0)
+	{
+		profile_next = cc_memory_nextSample();
+	}
+
+	if(size < profile_next)
+	{
+		profile_next -= size;
+		return 0;
+	}
+
+	profile_next = cc_memory_nextSample();
+	return 1;
+}
+
+static int cc_memory_profileInit(void)
+{
+	if(profile_map_sample)
+	{
+		return 1;
+	}
+
+	profile_map_site = cc_map_newCMalloc();
+	if(profile_map_site == NULL)
+	{
+		return 0;
+	}
+
+	profile_map_sample = cc_ptrmap_newCMalloc();
+	if(profile_map_sample == NULL)
+	{
+		cc_map_delete(&profile_map_site);
+		return 0;
+	}
+
+	return 1;
+}
+
+static void
+cc_memory_profileAdd(const char* func, int line, void* ptr,
+                     size_t size)
+{
+	ASSERT(func);
+	ASSERT(ptr);
+
+	char name[CC_MEMORY_NAMELEN];
+	snprintf(name, CC_MEMORY_NAMELEN, "%s@%i", func, line);
+
+	double interval;
+	interval = (double)
+	           atomic_load_explicit(&profile_interval,
+	                                memory_order_relaxed);
+
+	cc_sample_t* sample;
+	sample = (cc_sample_t*) malloc(sizeof(cc_sample_t));
+	if(sample == NULL)
+	{
+		LOGE("malloc failed");
+		return;
+	}
+
+	// probability of sampling an allocation of size
+	sample->size   = size;
+	sample->weight = 1.0;
+	if(size > 0)
+	{
+		sample->weight = 1.0/(1.0 - exp(-((double) size)/
+		                                interval));
+	}
+
+	pthread_mutex_lock(&profile_mutex);
+
+	if(cc_memory_profileInit() == 0)
+	{
+		goto fail_init;
+	}
+
+	// get site
+	cc_site_t*    site;
+	cc_mapIter_t* miter;
+	miter = cc_map_find(profile_map_site, name);
+	if(miter == NULL)
+	{
+		site = (cc_site_t*) calloc(1, sizeof(cc_site_t));
+		if(site == NULL)
+		{
+			LOGE("calloc failed");
+			goto fail_site;
+		}
+		snprintf(site->name, CC_MEMORY_NAMELEN, "%s", name);
+
+		if(cc_map_add(profile_map_site, (const void*) site,
+		              name) == NULL)
+		{
+			free(site);
+			goto fail_site;
+		}
+	}
+	else
+	{
+		site = (cc_site_t*) cc_map_val(miter);
+	}
+	sample->site_ref = site;
+
+	if(cc_ptrmap_addp(profile_map_sample, (const void*) sample,
+	                  ptr) == NULL)
+	{
+		goto fail_sample;
+	}
+
+	// mark the block as sampled so that free only needs to
+	// lookup sampled blocks
+	cc_memory_t* mem = ptr - sizeof(cc_memory_t);
+	mem->flags |= CC_MEMORY_FLAG_SAMPLED;
+
+	site->count += sample->weight;
+	site->size  += sample->weight*((double) size);
+
+	pthread_mutex_unlock(&profile_mutex);
+
+	// success
+	return;
+
+	// failure
+	fail_sample:
+	fail_site:
+	fail_init:
+		pthread_mutex_unlock(&profile_mutex);
+		free(sample);
+}
+
+// the sample must be detached while the block is still
+// allocated since another thread may reuse the address
+// once the block has been freed
+static cc_sample_t* cc_memory_profileDetach(void* ptr)
+{
+	ASSERT(ptr);
+
+	cc_memory_t* mem = ptr - sizeof(cc_memory_t);
+	if((mem->flags & CC_MEMORY_FLAG_SAMPLED) == 0)
+	{
+		return NULL;
+	}
+	mem->flags &= ~CC_MEMORY_FLAG_SAMPLED;
+
+	pthread_mutex_lock(&profile_mutex);
+
+	cc_sample_t*     sample = NULL;
+	cc_ptrmapIter_t* miter;
+	miter = cc_ptrmap_findp(profile_map_sample, ptr);
+	if(miter)
+	{
+		sample = (cc_sample_t*)
+		         cc_ptrmap_remove(profile_map_sample, &miter);
+
+		cc_site_t* site = sample->site_ref;
+		site->count -= sample->weight;
+		site->size  -= sample->weight*((double) sample->size);
+	}
+
+	pthread_mutex_unlock(&profile_mutex);
+
+	return sample;
+}
+
+static void
+cc_memory_profileAttach(void* ptr, cc_sample_t* sample)
+{
+	ASSERT(ptr);
+	ASSERT(sample);
+
+	pthread_mutex_lock(&profile_mutex);
+
+	if(cc_ptrmap_addp(profile_map_sample, (const void*) sample,
+	                  ptr) == NULL)
+	{
+		pthread_mutex_unlock(&profile_mutex);
+		free(sample);
+		return;
+	}
+
+	cc_memory_t* mem = ptr - sizeof(cc_memory_t);
+	mem->flags |= CC_MEMORY_FLAG_SAMPLED;
+
+	cc_site_t* site = sample->site_ref;
+	site->count += sample->weight;
+	site->size  += sample->weight*((double) sample->size);
+
+	pthread_mutex_unlock(&profile_mutex);
+}
+
+static void cc_memory_profileRem(void* ptr)
+{
+	ASSERT(ptr);
+
+	free(cc_memory_profileDetach(ptr));
 }
 
 /***********************************************************
-* public - debug                                           *
+* public - profile                                         *
 ***********************************************************/
 
-void* cc_malloc_debug(const char* func, int line,
-                      size_t size)
+void* cc_malloc_profile(const char* func, int line,
+                        size_t size)
 {
 	void* ptr = cc_malloc(size);
-	cc_memory_add(func, line, ptr, size);
+	if(ptr && cc_memory_sample(size))
+	{
+		cc_memory_profileAdd(func, line, ptr, size);
+	}
 	return ptr;
 }
 
-void* cc_calloc_debug(const char* func, int line,
-                      size_t count, size_t size)
+void* cc_calloc_profile(const char* func, int line,
+                        size_t count, size_t size)
 {
 	void* ptr = cc_calloc(count, size);
-	cc_memory_add(func, line, ptr, count*size);
+	if(ptr && cc_memory_sample(count*size))
+	{
+		cc_memory_profileAdd(func, line, ptr, count*size);
+	}
 	return ptr;
 }
 
-void* cc_realloc_debug(const char* func, int line,
-                       void* ptr, size_t size)
+void* cc_realloc_profile(const char* func, int line,
+                         void* ptr, size_t size)
 {
-	cc_memory_rem(func, line, ptr);
+	// detach the sample of the old block before it is freed
+	// and restore it if the realloc fails
+	cc_sample_t* sample = NULL;
+	if(ptr)
+	{
+		sample = cc_memory_profileDetach(ptr);
+	}
+
 	void* reptr = cc_realloc(ptr, size);
-	if(reptr)
+	if(reptr == NULL)
 	{
-		cc_memory_add(func, line, reptr, size);
+		if(sample)
+		{
+			cc_memory_profileAttach(ptr, sample);
+		}
+		return NULL;
 	}
-	else
+	free(sample);
+
+	// the new block is sampled by its new size
+	if(cc_memory_sample(size))
 	{
-		cc_memory_add(func, line, ptr, size);
+		cc_memory_profileAdd(func, line, reptr, size);
 	}
 	return reptr;
 }
 
-void cc_free_debug(const char* func, int line, void* ptr)
+void cc_free_profile(const char* func, int line, void* ptr)
 {
-	cc_memory_rem(func, line, ptr);
+	if(ptr)
+	{
+		cc_memory_profileRem(ptr);
+	}
 	cc_free(ptr);
 }
 
-void cc_meminfo_debug(void)
+void* cc_malloc_tag_profile(const char* func, int line,
+                            int tag, size_t size)
+{
+	void* ptr = cc_malloc_tag(tag, size);
+	if(ptr && cc_memory_sample(size))
+	{
+		cc_memory_profileAdd(func, line, ptr, size);
+	}
+	return ptr;
+}
+
+void* cc_calloc_tag_profile(const char* func, int line,
+                            int tag, size_t count, size_t size)
+{
+	void* ptr = cc_calloc_tag(tag, count, size);
+	if(ptr && cc_memory_sample(count*size))
+	{
+		cc_memory_profileAdd(func, line, ptr, count*size);
+	}
+	return ptr;
+}
+
+void* cc_malloc_aligned_profile(const char* func, int line,
+                                size_t alignment, size_t size)
+{
+	void* ptr = cc_malloc_aligned(alignment, size);
+	if(ptr && cc_memory_sample(size))
+	{
+		cc_memory_profileAdd(func, line, ptr, size);
+	}
+	return ptr;
+}
+
+void cc_free_aligned_profile(const char* func, int line,
+                             void* ptr)
+{
+	if(ptr)
+	{
+		cc_memory_profileRem(ptr);
+	}
+	cc_free_aligned(ptr);
+}
+
+void cc_meminfo_profile(void)
 {
 	cc_meminfo();
-	cc_memory_meminfo();
+
+	pthread_mutex_lock(&profile_mutex);
+
+	if(profile_map_site == NULL)
+	{
+		pthread_mutex_unlock(&profile_mutex);
+		return;
+	}
+
+	LOGI("interval=%" PRIu64 ", cnt_sample=%i",
+	     (uint64_t) atomic_load(&profile_interval),
+	     cc_ptrmap_size(profile_map_sample));
+
+	cc_mapIter_t* miter = cc_map_head(profile_map_site);
+	while(miter)
+	{
+		cc_site_t* site = (cc_site_t*) cc_map_val(miter);
+
+		LOGI("name=%s, est_count=%" PRIu64 ", est_size=%" PRIu64,
+		     site->name, (uint64_t) (site->count + 0.5),
+		     (uint64_t) (site->size + 0.5));
+
+		miter = cc_map_next(miter);
+	}
+
+	pthread_mutex_unlock(&profile_mutex);
 }
 
-int cc_memcheckptr_debug(const char* func, int line,
-                         void* ptr)
+void cc_memprofile_interval(size_t interval)
 {
-	return cc_memory_memcheckptr(func, line, ptr);
+	ASSERT(interval > 0);
+
+	atomic_store(&profile_interval, interval);
 }
 
-#endif // MEMORY_DEBUG
+#endif // MEMORY_PROFILE
 
 /***********************************************************
 * public                                                   *
@@ -531,21 +1524,14 @@ int cc_memcheckptr_debug(const char* func, int line,
 
 void* cc_malloc(size_t size)
 {
-	cc_memory_t* mem;
-	mem = (cc_memory_t*)
-	      malloc(size + sizeof(cc_memory_t));
+	cc_memory_t* mem = cc_memory_alloc(size);
 	if(mem == NULL)
 	{
 		return NULL;
 	}
-	mem->size = size;
 
-	pthread_mutex_lock(&memory_mutex);
-	++memory_count;
-	memory_size += mem->size;
-	LOGD("mem=%p, size=%i, memory_size=%i",
-	     mem, (int) mem->size, memory_size);
-	pthread_mutex_unlock(&memory_mutex);
+	cc_memory_inc(mem->size);
+	LOGD("mem=%p, size=%i", mem, (int) mem->size);
 
 	return (void*) mem + sizeof(cc_memory_t);
 }
@@ -553,20 +1539,30 @@ void* cc_malloc(size_t size)
 void* cc_calloc(size_t count, size_t size)
 {
 	cc_memory_t* mem;
-	mem = (cc_memory_t*)
-	      calloc(1, count*size + sizeof(cc_memory_t));
+	#ifdef CC_MEMORY_MMAP
+	if(cc_memory_usemmap(count*size))
+	{
+		mem = cc_memory_mmap(count*size);
+	}
+	else
+	#endif
+	{
+		mem = (cc_memory_t*)
+		      calloc(1, count*size + sizeof(cc_memory_t));
+		if(mem)
+		{
+			mem->flags = 0;
+		}
+	}
+
 	if(mem == NULL)
 	{
 		return NULL;
 	}
 	mem->size = count*size;
 
-	pthread_mutex_lock(&memory_mutex);
-	++memory_count;
-	memory_size += mem->size;
-	LOGD("mem=%p, size=%i, memory_size=%i",
-	     mem, (int) mem->size, memory_size);
-	pthread_mutex_unlock(&memory_mutex);
+	cc_memory_inc(mem->size);
+	LOGD("mem=%p, size=%i", mem, (int) mem->size);
 
 	return (void*) mem + sizeof(cc_memory_t);
 }
@@ -582,20 +1578,58 @@ void* cc_realloc(void* ptr, size_t size)
 	                     (ptr - sizeof(cc_memory_t));
 	size_t       size1 = mem1->size;
 
+	cc_memory_restat(size1, size);
+
+	// preserve the alignment of aligned blocks
+	size_t shift = (mem1->flags & CC_MEMORY_FLAG_ALIGN_MASK) >>
+	               CC_MEMORY_FLAG_ALIGN_SHIFT;
+	if(shift)
+	{
+		cc_memory_t* mem2;
+		mem2 = cc_memory_allocAligned((size_t) 1 << shift, size);
+		if(mem2 == NULL)
+		{
+			return NULL;
+		}
+
+		return cc_memory_move(mem1, mem2);
+	}
+
 	cc_memory_t* mem2;
-	mem2 = (cc_memory_t*)
-	       realloc((void*) mem1, size + sizeof(cc_memory_t));
+	#ifdef CC_MEMORY_MMAP
+	int mmap1 = (mem1->flags & CC_MEMORY_FLAG_MMAP) ? 1 : 0;
+	int mmap2 = cc_memory_usemmap(size);
+	if(mmap1 != mmap2)
+	{
+		// move between the heap and a mapping
+		mem2 = cc_memory_alloc(size);
+		if(mem2 == NULL)
+		{
+			return NULL;
+		}
+
+		return cc_memory_move(mem1, mem2);
+	}
+	else if(mmap1)
+	{
+		mem2 = cc_memory_mremap(mem1, size);
+	}
+	else
+	#endif
+	{
+		mem2 = (cc_memory_t*)
+		       realloc((void*) mem1, size + sizeof(cc_memory_t));
+	}
+
 	if(mem2 == NULL)
 	{
 		return NULL;
 	}
 	mem2->size = size;
 
-	pthread_mutex_lock(&memory_mutex);
-	memory_size += mem2->size - size1;
-	LOGD("mem=%p, size=%i, memory_size=%i",
-	     mem2, (int) mem2->size, memory_size);
-	pthread_mutex_unlock(&memory_mutex);
+	cc_memory_resize(size1, mem2->size);
+	cc_memtag_resize(cc_memory_tag(mem2), size1, mem2->size);
+	LOGD("mem=%p, size=%i", mem2, (int) mem2->size);
 
 	return (void*) mem2 + sizeof(cc_memory_t);
 }
@@ -606,43 +1640,259 @@ void cc_free(void* ptr)
 	{
 		cc_memory_t* mem = ptr - sizeof(cc_memory_t);
 
-		pthread_mutex_lock(&memory_mutex);
-		--memory_count;
-		memory_size -= mem->size;
-		LOGD("mem=%p, size=%i, memory_size=%i",
-		     mem, (int) mem->size, memory_size);
-		pthread_mutex_unlock(&memory_mutex);
+		cc_memory_dec(mem->size);
+		cc_memtag_dec(cc_memory_tag(mem), mem->size);
+		LOGD("mem=%p, size=%i", mem, (int) mem->size);
+
+		cc_memory_release(mem);
+	}
+}
+
+void* cc_malloc_tag(int tag, size_t size)
+{
+	ASSERT((tag >= 0) && (tag < CC_MEMTAG_COUNT));
+
+	void* ptr = cc_malloc(size);
+	if(ptr)
+	{
+		cc_memory_t* mem = ptr - sizeof(cc_memory_t);
+		mem->flags |= ((size_t) tag) << CC_MEMORY_FLAG_TAG_SHIFT;
+		cc_memtag_inc(tag, size);
+	}
+
+	return ptr;
+}
+
+void* cc_calloc_tag(int tag, size_t count, size_t size)
+{
+	ASSERT((tag >= 0) && (tag < CC_MEMTAG_COUNT));
+
+	void* ptr = cc_calloc(count, size);
+	if(ptr)
+	{
+		cc_memory_t* mem = ptr - sizeof(cc_memory_t);
+		mem->flags |= ((size_t) tag) << CC_MEMORY_FLAG_TAG_SHIFT;
+		cc_memtag_inc(tag, count*size);
+	}
+
+	return ptr;
+}
 
-		free(mem);
+void* cc_malloc_aligned(size_t alignment, size_t size)
+{
+	cc_memory_t* mem = cc_memory_allocAligned(alignment, size);
+	if(mem == NULL)
+	{
+		return NULL;
 	}
+
+	cc_memory_inc(mem->size);
+	LOGD("mem=%p, size=%i", mem, (int) mem->size);
+
+	return (void*) mem + sizeof(cc_memory_t);
+}
+
+void cc_free_aligned(void* ptr)
+{
+	cc_free(ptr);
 }
 
 size_t cc_memcount(void)
 {
-	size_t count;
-	pthread_mutex_lock(&memory_mutex);
-	count = memory_count;
-	pthread_mutex_unlock(&memory_mutex);
+	size_t count = 0;
+
+	int i;
+	for(i = 0; i < CC_MEMORY_SHARDS; ++i)
+	{
+		count += atomic_load_explicit(&memory_shards[i].count,
+		                              memory_order_relaxed);
+	}
+
 	return count;
 }
 
 void cc_meminfo(void)
 {
-	pthread_mutex_lock(&memory_mutex);
 	LOGI("count=%i, size=%" PRIu64,
-	     (int) memory_count, (uint64_t) memory_size);
-	pthread_mutex_unlock(&memory_mutex);
+	     (int) cc_memcount(), (uint64_t) cc_memsize());
+
+	cc_memtagStats_t stats;
+
+	int tag;
+	for(tag = 1; tag < CC_MEMTAG_COUNT; ++tag)
+	{
+		cc_memtag_stats(tag, &stats);
+		if(stats.alloc_count == 0)
+		{
+			continue;
+		}
+
+		LOGI("tag=%i, count=%i, size=%" PRIu64 ", peak=%" PRIu64,
+		     tag, (int) stats.count, (uint64_t) stats.size,
+		     (uint64_t) stats.peak);
+	}
+}
+
+void cc_memstats(cc_memstats_t* stats)
+{
+	ASSERT(stats);
+
+	memset(stats, 0, sizeof(cc_memstats_t));
+
+	cc_memory_peak();
+
+	stats->ts    = cc_timestamp();
+	stats->count = cc_memcount();
+	stats->size  = cc_memsize();
+	stats->peak  = atomic_load_explicit(&memory_peak,
+	                                    memory_order_relaxed);
+
+	int i;
+	int j;
+	for(i = 0; i < CC_MEMORY_SHARDS; ++i)
+	{
+		cc_memoryShard_t* shard = &memory_shards[i];
+
+		stats->alloc_count +=
+			atomic_load_explicit(&shard->alloc_count,
+			                     memory_order_relaxed);
+		stats->free_count +=
+			atomic_load_explicit(&shard->free_count,
+			                     memory_order_relaxed);
+		stats->realloc_count +=
+			atomic_load_explicit(&shard->realloc_count,
+			                     memory_order_relaxed);
+		stats->realloc_grow +=
+			atomic_load_explicit(&shard->realloc_grow,
+			                     memory_order_relaxed);
+		stats->realloc_grow_size +=
+			atomic_load_explicit(&shard->realloc_grow_size,
+			                     memory_order_relaxed);
+		stats->realloc_shrink +=
+			atomic_load_explicit(&shard->realloc_shrink,
+			                     memory_order_relaxed);
+		stats->realloc_shrink_size +=
+			atomic_load_explicit(&shard->realloc_shrink_size,
+			                     memory_order_relaxed);
+
+		for(j = 0; j < CC_MEMSTATS_BUCKETS; ++j)
+		{
+			stats->histogram[j] +=
+				atomic_load_explicit(&shard->histogram[j],
+				                     memory_order_relaxed);
+		}
+	}
 }
 
 size_t cc_memsize(void)
 {
-	size_t size;
-	pthread_mutex_lock(&memory_mutex);
-	size = memory_size;
-	pthread_mutex_unlock(&memory_mutex);
+	size_t size = 0;
+
+	int i;
+	for(i = 0; i < CC_MEMORY_SHARDS; ++i)
+	{
+		size += atomic_load_explicit(&memory_shards[i].size,
+		                             memory_order_relaxed);
+	}
+
 	return size;
 }
 
+void cc_memtag_inc(int tag, size_t size)
+{
+	ASSERT((tag >= 0) && (tag < CC_MEMTAG_COUNT));
+
+	if(tag == CC_MEMTAG_NONE)
+	{
+		return;
+	}
+
+	cc_memoryShard_t* shard = cc_memory_shard();
+	atomic_fetch_add_explicit(&shard->tag_count[tag], 1,
+	                          memory_order_relaxed);
+	atomic_fetch_add_explicit(&shard->tag_alloc_count[tag], 1,
+	                          memory_order_relaxed);
+	cc_memtag_grow(tag, size);
+}
+
+void cc_memtag_dec(int tag, size_t size)
+{
+	ASSERT((tag >= 0) && (tag < CC_MEMTAG_COUNT));
+
+	if(tag == CC_MEMTAG_NONE)
+	{
+		return;
+	}
+
+	cc_memoryShard_t* shard = cc_memory_shard();
+	atomic_fetch_sub_explicit(&shard->tag_count[tag], 1,
+	                          memory_order_relaxed);
+	cc_memtag_shrink(tag, size);
+}
+
+void cc_memtag_stats(int tag, cc_memtagStats_t* stats)
+{
+	ASSERT((tag >= 0) && (tag < CC_MEMTAG_COUNT));
+	ASSERT(stats);
+
+	cc_memtag_t* self = &memory_tags[tag];
+
+	memset(stats, 0, sizeof(cc_memtagStats_t));
+
+	int i;
+	for(i = 0; i < CC_MEMORY_SHARDS; ++i)
+	{
+		cc_memoryShard_t* shard = &memory_shards[i];
+
+		stats->size +=
+			atomic_load_explicit(&shard->tag_size[tag],
+			                     memory_order_relaxed);
+		stats->count +=
+			atomic_load_explicit(&shard->tag_count[tag],
+			                     memory_order_relaxed);
+		stats->alloc_count +=
+			atomic_load_explicit(&shard->tag_alloc_count[tag],
+			                     memory_order_relaxed);
+	}
+
+	cc_memtag_peak(tag, stats->size);
+
+	stats->peak   = atomic_load(&self->peak);
+	stats->budget = atomic_load(&self->budget);
+}
+
+void cc_memtag_budget(int tag, size_t budget,
+                      cc_memtag_budgetFn budget_fn,
+                      void* budget_priv)
+{
+	// budget_fn and budget_priv may be NULL
+	ASSERT((tag > 0) && (tag < CC_MEMTAG_COUNT));
+
+	cc_memtag_t* self = &memory_tags[tag];
+
+	pthread_mutex_lock(&memory_tag_mutex);
+	self->budget_fn   = budget_fn;
+	self->budget_priv = budget_priv;
+	pthread_mutex_unlock(&memory_tag_mutex);
+
+	atomic_store(&self->over, 0);
+	atomic_store(&self->budget, budget);
+}
+
+void cc_memmmap_threshold(size_t threshold)
+{
+	#ifdef CC_MEMORY_MMAP
+	atomic_store(&memory_mmap_threshold, threshold);
+	#endif
+}
+
+void cc_memmmap_hugepage(int hugepage)
+{
+	#ifdef CC_MEMORY_MMAP
+	atomic_store(&memory_mmap_hugepage, hugepage);
+	#endif
+}
+
 size_t cc_memsizeptr(void* ptr)
 {
 	size_t size = 0;
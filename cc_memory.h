@@ -24,6 +24,54 @@
 #ifndef cc_memory_H
 #define cc_memory_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+// library tags
+// applications may use CC_MEMTAG_USER and above
+#define CC_MEMTAG_NONE     0
+#define CC_MEMTAG_MAP      1
+#define CC_MEMTAG_LIST     2
+#define CC_MEMTAG_WORKQ    3
+#define CC_MEMTAG_JSMN     4
+#define CC_MEMTAG_ARENA    5
+#define CC_MEMTAG_VECTOR   6
+#define CC_MEMTAG_SKIPLIST 7
+#define CC_MEMTAG_USER     16
+#define CC_MEMTAG_COUNT    64
+
+#define CC_MEMSTATS_BUCKETS 48
+
+typedef struct
+{
+	double   ts;
+	uint64_t count;
+	uint64_t size;
+	uint64_t peak;
+	uint64_t alloc_count;
+	uint64_t free_count;
+	uint64_t realloc_count;
+	uint64_t realloc_grow;
+	uint64_t realloc_grow_size;
+	uint64_t realloc_shrink;
+	uint64_t realloc_shrink_size;
+
+	// histogram[n] counts allocations of size < 2^n
+	uint64_t histogram[CC_MEMSTATS_BUCKETS];
+} cc_memstats_t;
+
+typedef struct
+{
+	size_t   size;
+	size_t   peak;
+	size_t   count;
+	uint64_t alloc_count;
+	size_t   budget;
+} cc_memtagStats_t;
+
+typedef void (*cc_memtag_budgetFn)(void* priv, int tag,
+                                   size_t size, size_t budget);
+
 #ifdef MEMORY_DEBUG
 void* cc_malloc_debug(const char* func, int line,
                       size_t size);
@@ -32,22 +80,111 @@ void* cc_calloc_debug(const char* func, int line,
 void* cc_realloc_debug(const char* func, int line,
                        void* ptr, size_t size);
 void  cc_free_debug(const char* func, int line, void* ptr);
+void* cc_malloc_tag_debug(const char* func, int line,
+                          int tag, size_t size);
+void* cc_calloc_tag_debug(const char* func, int line,
+                          int tag, size_t count, size_t size);
+void* cc_malloc_aligned_debug(const char* func, int line,
+                              size_t alignment, size_t size);
+void  cc_free_aligned_debug(const char* func, int line,
+                            void* ptr);
 int   cc_memcheckptr_debug(const char* func, int line, void* ptr);
 void  cc_meminfo_debug(void);
 #endif
 
+#ifdef MEMORY_PROFILE
+void* cc_malloc_profile(const char* func, int line,
+                        size_t size);
+void* cc_calloc_profile(const char* func, int line,
+                        size_t count, size_t size);
+void* cc_realloc_profile(const char* func, int line,
+                         void* ptr, size_t size);
+void  cc_free_profile(const char* func, int line, void* ptr);
+void* cc_malloc_tag_profile(const char* func, int line,
+                            int tag, size_t size);
+void* cc_calloc_tag_profile(const char* func, int line,
+                            int tag, size_t count, size_t size);
+void* cc_malloc_aligned_profile(const char* func, int line,
+                                size_t alignment, size_t size);
+void  cc_free_aligned_profile(const char* func, int line,
+                              void* ptr);
+void  cc_meminfo_profile(void);
+void  cc_memprofile_interval(size_t interval);
+#endif
+
 void*  cc_malloc(size_t size);
 void*  cc_calloc(size_t count, size_t size);
 void*  cc_realloc(void* ptr, size_t size);
 void   cc_free(void* ptr);
+void*  cc_malloc_tag(int tag, size_t size);
+void*  cc_calloc_tag(int tag, size_t count, size_t size);
+void*  cc_malloc_aligned(size_t alignment, size_t size);
+void   cc_free_aligned(void* ptr);
 size_t cc_memcount(void);
 void   cc_meminfo(void);
 size_t cc_memsize(void);
+void   cc_memstats(cc_memstats_t* stats);
+void   cc_memtag_inc(int tag, size_t size);
+void   cc_memtag_dec(int tag, size_t size);
+void   cc_memtag_stats(int tag, cc_memtagStats_t* stats);
+void   cc_memtag_budget(int tag, size_t budget,
+                        cc_memtag_budgetFn budget_fn,
+                        void* budget_priv);
 size_t cc_memsizeptr(void* ptr);
+void   cc_memmmap_threshold(size_t threshold);
+void   cc_memmmap_hugepage(int hugepage);
+
+// CC_MEMORY_RAW maps the allocation macros directly to the
+// system allocator which removes the header and accounting
+// from each allocation. The MEMCOUNT/MEMSIZE/MEMINFO totals
+// and tag statistics only include allocations made by
+// calling cc_malloc directly. CC_MEMORY_RAW must be defined
+// consistently for the library and its users.
+#ifdef CC_MEMORY_RAW
+	#if defined(MEMORY_DEBUG) || defined(MEMORY_PROFILE)
+		#error "CC_MEMORY_RAW is incompatible with MEMORY_DEBUG/MEMORY_PROFILE"
+	#endif
+
+	#include <stdlib.h>
+	#ifdef __APPLE__
+		#include <malloc/malloc.h>
+		#define MEMSIZEPTR(...) (malloc_size(__VA_ARGS__))
+	#else
+		#include <malloc.h>
+		#define MEMSIZEPTR(...) (malloc_usable_size(__VA_ARGS__))
+	#endif
+
+	static inline void*
+	cc_malloc_raw_aligned(size_t alignment, size_t size)
+	{
+		void* ptr = NULL;
+		if(alignment < sizeof(void*))
+		{
+			alignment = sizeof(void*);
+		}
+
+		if(posix_memalign(&ptr, alignment, size) != 0)
+		{
+			return NULL;
+		}
+		return ptr;
+	}
+
+	#define MALLOC(...)                   (malloc(__VA_ARGS__))
+	#define CALLOC(...)                   (calloc(__VA_ARGS__))
+	#define REALLOC(...)                  (realloc(__VA_ARGS__))
+	#define FREE(...)                     (free(__VA_ARGS__))
+	#define MALLOC_TAG(tag, size)         (malloc(size))
+	#define CALLOC_TAG(tag, count, size)  (calloc(count, size))
+	#define MALLOC_ALIGNED(...)           (cc_malloc_raw_aligned(__VA_ARGS__))
+	#define FREE_ALIGNED(...)             (free(__VA_ARGS__))
+#endif
 
 #ifndef MALLOC
 	#ifdef MEMORY_DEBUG
 		#define MALLOC(...) (cc_malloc_debug(__func__, __LINE__, __VA_ARGS__))
+	#elif defined(MEMORY_PROFILE)
+		#define MALLOC(...) (cc_malloc_profile(__func__, __LINE__, __VA_ARGS__))
 	#else
 		#define MALLOC(...) (cc_malloc(__VA_ARGS__))
 	#endif
@@ -56,6 +193,8 @@ size_t cc_memsizeptr(void* ptr);
 #ifndef CALLOC
 	#ifdef MEMORY_DEBUG
 		#define CALLOC(...) (cc_calloc_debug(__func__, __LINE__, __VA_ARGS__))
+	#elif defined(MEMORY_PROFILE)
+		#define CALLOC(...) (cc_calloc_profile(__func__, __LINE__, __VA_ARGS__))
 	#else
 		#define CALLOC(...) (cc_calloc(__VA_ARGS__))
 	#endif
@@ -64,6 +203,8 @@ size_t cc_memsizeptr(void* ptr);
 #ifndef REALLOC
 	#ifdef MEMORY_DEBUG
 		#define REALLOC(...) (cc_realloc_debug(__func__, __LINE__, __VA_ARGS__))
+	#elif defined(MEMORY_PROFILE)
+		#define REALLOC(...) (cc_realloc_profile(__func__, __LINE__, __VA_ARGS__))
 	#else
 		#define REALLOC(...) (cc_realloc(__VA_ARGS__))
 	#endif
@@ -72,11 +213,53 @@ size_t cc_memsizeptr(void* ptr);
 #ifndef FREE
 	#ifdef MEMORY_DEBUG
 		#define FREE(...) (cc_free_debug(__func__, __LINE__, __VA_ARGS__))
+	#elif defined(MEMORY_PROFILE)
+		#define FREE(...) (cc_free_profile(__func__, __LINE__, __VA_ARGS__))
 	#else
 		#define FREE(...) (cc_free(__VA_ARGS__))
 	#endif
 #endif
 
+#ifndef MALLOC_TAG
+	#ifdef MEMORY_DEBUG
+		#define MALLOC_TAG(...) (cc_malloc_tag_debug(__func__, __LINE__, __VA_ARGS__))
+	#elif defined(MEMORY_PROFILE)
+		#define MALLOC_TAG(...) (cc_malloc_tag_profile(__func__, __LINE__, __VA_ARGS__))
+	#else
+		#define MALLOC_TAG(...) (cc_malloc_tag(__VA_ARGS__))
+	#endif
+#endif
+
+#ifndef CALLOC_TAG
+	#ifdef MEMORY_DEBUG
+		#define CALLOC_TAG(...) (cc_calloc_tag_debug(__func__, __LINE__, __VA_ARGS__))
+	#elif defined(MEMORY_PROFILE)
+		#define CALLOC_TAG(...) (cc_calloc_tag_profile(__func__, __LINE__, __VA_ARGS__))
+	#else
+		#define CALLOC_TAG(...) (cc_calloc_tag(__VA_ARGS__))
+	#endif
+#endif
+
+#ifndef MALLOC_ALIGNED
+	#ifdef MEMORY_DEBUG
+		#define MALLOC_ALIGNED(...) (cc_malloc_aligned_debug(__func__, __LINE__, __VA_ARGS__))
+	#elif defined(MEMORY_PROFILE)
+		#define MALLOC_ALIGNED(...) (cc_malloc_aligned_profile(__func__, __LINE__, __VA_ARGS__))
+	#else
+		#define MALLOC_ALIGNED(...) (cc_malloc_aligned(__VA_ARGS__))
+	#endif
+#endif
+
+#ifndef FREE_ALIGNED
+	#ifdef MEMORY_DEBUG
+		#define FREE_ALIGNED(...) (cc_free_aligned_debug(__func__, __LINE__, __VA_ARGS__))
+	#elif defined(MEMORY_PROFILE)
+		#define FREE_ALIGNED(...) (cc_free_aligned_profile(__func__, __LINE__, __VA_ARGS__))
+	#else
+		#define FREE_ALIGNED(...) (cc_free_aligned(__VA_ARGS__))
+	#endif
+#endif
+
 #ifndef MEMCHECK
 	#ifdef MEMORY_DEBUG
 		#define MEMCHECKPTR(...) (cc_memcheckptr_debug(__func__, __LINE__, __VA_ARGS__))
@@ -92,6 +275,8 @@ size_t cc_memsizeptr(void* ptr);
 #ifndef MEMINFO
 	#ifdef MEMORY_DEBUG
 		#define MEMINFO(...) (cc_meminfo_debug())
+	#elif defined(MEMORY_PROFILE)
+		#define MEMINFO(...) (cc_meminfo_profile())
 	#else
 		#define MEMINFO(...) (cc_meminfo())
 	#endif
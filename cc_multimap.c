@@ -31,6 +31,131 @@
 #include "cc_memory.h"
 #include "cc_multimap.h"
 
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static void
+cc_multimap_setIter(cc_multimapIter_t* mmiter,
+                    int skiplist)
+{
+	ASSERT(mmiter);
+	ASSERT(mmiter->miter);
+
+	mmiter->skiplist = skiplist;
+	if(skiplist)
+	{
+		cc_skiplist_t* sl;
+		sl = (cc_skiplist_t*) cc_map_val(mmiter->miter);
+		mmiter->iter  = NULL;
+		mmiter->siter = cc_skiplist_head(sl);
+	}
+	else
+	{
+		cc_list_t* list;
+		list = (cc_list_t*) cc_map_val(mmiter->miter);
+		mmiter->iter  = cc_list_head(list);
+		mmiter->siter = NULL;
+	}
+}
+
+static int
+cc_multimap_insert(cc_multimap_t* self, void* container,
+                   const void* val)
+{
+	ASSERT(self);
+	ASSERT(container);
+	ASSERT(val);
+
+	if(self->skiplist)
+	{
+		cc_skiplist_t* sl = (cc_skiplist_t*) container;
+		if(cc_skiplist_insert(sl, val) == NULL)
+		{
+			return 0;
+		}
+	}
+	else if(self->compare)
+	{
+		cc_list_t* list = (cc_list_t*) container;
+		if(cc_list_insertSorted(list, self->compare,
+		                        val) == NULL)
+		{
+			return 0;
+		}
+	}
+	else
+	{
+		cc_list_t* list = (cc_list_t*) container;
+		if(cc_list_append(list, NULL, val) == NULL)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static void*
+cc_multimap_newContainer(cc_multimap_t* self,
+                         const void* val)
+{
+	ASSERT(self);
+	ASSERT(val);
+
+	if(self->skiplist)
+	{
+		cc_skiplist_t* sl = cc_skiplist_new(self->compare);
+		if(sl == NULL)
+		{
+			return NULL;
+		}
+
+		if(cc_skiplist_insert(sl, val) == NULL)
+		{
+			cc_skiplist_delete(&sl);
+			return NULL;
+		}
+
+		return (void*) sl;
+	}
+
+	cc_list_t* list = cc_list_new();
+	if(list == NULL)
+	{
+		return NULL;
+	}
+
+	if(cc_list_append(list, NULL, val) == NULL)
+	{
+		cc_list_delete(&list);
+		return NULL;
+	}
+
+	return (void*) list;
+}
+
+static void
+cc_multimap_deleteContainer(cc_multimap_t* self,
+                            void* container)
+{
+	ASSERT(self);
+	ASSERT(container);
+
+	if(self->skiplist)
+	{
+		cc_skiplist_t* sl = (cc_skiplist_t*) container;
+		cc_skiplist_discard(sl);
+		cc_skiplist_delete(&sl);
+	}
+	else
+	{
+		cc_list_t* list = (cc_list_t*) container;
+		cc_list_discard(list);
+		cc_list_delete(&list);
+	}
+}
+
 /***********************************************************
 * public                                                   *
 ***********************************************************/
@@ -53,7 +178,8 @@ cc_multimap_t* cc_multimap_new(cc_listcmp_fn compare)
 		goto fail_map;
 	}
 
-	self->compare = compare;
+	self->compare  = compare;
+	self->skiplist = 0;
 
 	// success
 	return self;
@@ -64,6 +190,21 @@ cc_multimap_t* cc_multimap_new(cc_listcmp_fn compare)
 	return NULL;
 }
 
+cc_multimap_t* cc_multimap_newSkiplist(cc_listcmp_fn compare)
+{
+	ASSERT(compare);
+
+	cc_multimap_t* self = cc_multimap_new(compare);
+	if(self == NULL)
+	{
+		return NULL;
+	}
+
+	self->skiplist = 1;
+
+	return self;
+}
+
 void cc_multimap_delete(cc_multimap_t** _self)
 {
 	ASSERT(_self);
@@ -84,11 +225,9 @@ void cc_multimap_discard(cc_multimap_t* self)
 	cc_mapIter_t* miter = cc_map_head(self->map);
 	while(miter)
 	{
-		cc_list_t* list;
-		list = (cc_list_t*)
-		       cc_map_remove(self->map, &miter);
-		cc_list_discard(list);
-		cc_list_delete(&list);
+		void* container;
+		container = (void*) cc_map_remove(self->map, &miter);
+		cc_multimap_deleteContainer(self, container);
 	}
 }
 
@@ -119,8 +258,7 @@ cc_multimap_head(const cc_multimap_t* self,
 		return NULL;
 	}
 
-	cc_list_t* list = (cc_list_t*) cc_map_val(mmiter->miter);
-	mmiter->iter = cc_list_head(list);
+	cc_multimap_setIter(mmiter, self->skiplist);
 
 	return mmiter;
 }
@@ -129,28 +267,29 @@ cc_multimapIter_t* cc_multimap_next(cc_multimapIter_t* mmiter)
 {
 	ASSERT(mmiter);
 
-	mmiter->iter = cc_list_next(mmiter->iter);
-	if(mmiter->iter)
+	if(cc_multimap_nextItem(mmiter))
 	{
 		return mmiter;
 	}
 
-	mmiter->miter = cc_map_next(mmiter->miter);
-	if(mmiter->miter == NULL)
-	{
-		return NULL;
-	}
-
-	cc_list_t* list = (cc_list_t*) cc_map_val(mmiter->miter);
-	mmiter->iter = cc_list_head(list);
-
-	return mmiter;
+	return cc_multimap_nextList(mmiter);
 }
 
 cc_multimapIter_t* cc_multimap_nextItem(cc_multimapIter_t* mmiter)
 {
 	ASSERT(mmiter);
 
+	if(mmiter->skiplist)
+	{
+		mmiter->siter = cc_skiplist_next(mmiter->siter);
+		if(mmiter->siter)
+		{
+			return mmiter;
+		}
+
+		return NULL;
+	}
+
 	mmiter->iter = cc_list_next(mmiter->iter);
 	if(mmiter->iter)
 	{
@@ -170,8 +309,7 @@ cc_multimapIter_t* cc_multimap_nextList(cc_multimapIter_t* mmiter)
 		return NULL;
 	}
 
-	cc_list_t* list = (cc_list_t*) cc_map_val(mmiter->miter);
-	mmiter->iter = cc_list_head(list);
+	cc_multimap_setIter(mmiter, mmiter->skiplist);
 
 	return mmiter;
 }
@@ -189,6 +327,11 @@ const void* cc_multimap_val(const cc_multimapIter_t* mmiter)
 {
 	ASSERT(mmiter);
 
+	if(mmiter->skiplist)
+	{
+		return cc_skiplist_peekIter(mmiter->siter);
+	}
+
 	return cc_list_peekIter(mmiter->iter);
 }
 
@@ -196,10 +339,20 @@ const cc_list_t*
 cc_multimap_list(const cc_multimapIter_t* mmiter)
 {
 	ASSERT(mmiter);
+	ASSERT(mmiter->skiplist == 0);
 
 	return (const cc_list_t*) cc_map_val(mmiter->miter);
 }
 
+const cc_skiplist_t*
+cc_multimap_skiplist(const cc_multimapIter_t* mmiter)
+{
+	ASSERT(mmiter);
+	ASSERT(mmiter->skiplist);
+
+	return (const cc_skiplist_t*) cc_map_val(mmiter->miter);
+}
+
 const cc_list_t*
 cc_multimap_findp(const cc_multimap_t* self,
                   cc_multimapIter_t* mmiter,
@@ -207,6 +360,7 @@ cc_multimap_findp(const cc_multimap_t* self,
                   const void* key)
 {
 	ASSERT(self);
+	ASSERT(self->skiplist == 0);
 	ASSERT(mmiter);
 	ASSERT(key);
 
@@ -216,12 +370,9 @@ cc_multimap_findp(const cc_multimap_t* self,
 		return NULL;
 	}
 
-	cc_list_t* list;
-	list = (cc_list_t*) cc_map_val(mmiter->miter);
-
-	mmiter->iter = cc_list_head(list);
+	cc_multimap_setIter(mmiter, 0);
 
-	return list;
+	return (const cc_list_t*) cc_map_val(mmiter->miter);
 }
 
 const cc_list_t*
@@ -230,6 +381,7 @@ cc_multimap_find(const cc_multimap_t* self,
                  const char* key)
 {
 	ASSERT(self);
+	ASSERT(self->skiplist == 0);
 	ASSERT(mmiter);
 	ASSERT(key);
 
@@ -239,12 +391,9 @@ cc_multimap_find(const cc_multimap_t* self,
 		return NULL;
 	}
 
-	cc_list_t* list;
-	list = (cc_list_t*) cc_map_val(mmiter->miter);
+	cc_multimap_setIter(mmiter, 0);
 
-	mmiter->iter = cc_list_head(list);
-
-	return list;
+	return (const cc_list_t*) cc_map_val(mmiter->miter);
 }
 
 const cc_list_t*
@@ -265,6 +414,67 @@ cc_multimap_findf(const cc_multimap_t* self,
 	return cc_multimap_find(self, mmiter, key);
 }
 
+const cc_skiplist_t*
+cc_multimap_findpSkiplist(const cc_multimap_t* self,
+                          cc_multimapIter_t* mmiter,
+                          int len,
+                          const void* key)
+{
+	ASSERT(self);
+	ASSERT(self->skiplist);
+	ASSERT(mmiter);
+	ASSERT(key);
+
+	mmiter->miter = cc_map_findp(self->map, len, key);
+	if(mmiter->miter == NULL)
+	{
+		return NULL;
+	}
+
+	cc_multimap_setIter(mmiter, 1);
+
+	return (const cc_skiplist_t*) cc_map_val(mmiter->miter);
+}
+
+const cc_skiplist_t*
+cc_multimap_findSkiplist(const cc_multimap_t* self,
+                         cc_multimapIter_t* mmiter,
+                         const char* key)
+{
+	ASSERT(self);
+	ASSERT(self->skiplist);
+	ASSERT(mmiter);
+	ASSERT(key);
+
+	mmiter->miter = cc_map_find(self->map, key);
+	if(mmiter->miter == NULL)
+	{
+		return NULL;
+	}
+
+	cc_multimap_setIter(mmiter, 1);
+
+	return (const cc_skiplist_t*) cc_map_val(mmiter->miter);
+}
+
+const cc_skiplist_t*
+cc_multimap_findfSkiplist(const cc_multimap_t* self,
+                          cc_multimapIter_t* mmiter,
+                          const char* fmt, ...)
+{
+	ASSERT(self);
+	ASSERT(mmiter);
+	ASSERT(fmt);
+
+	char key[256];
+	va_list argptr;
+	va_start(argptr, fmt);
+	vsnprintf(key, 256, fmt, argptr);
+	va_end(argptr);
+
+	return cc_multimap_findSkiplist(self, mmiter, key);
+}
+
 int cc_multimap_addp(cc_multimap_t* self,
                      const void* val,
                      int len,
@@ -274,53 +484,24 @@ int cc_multimap_addp(cc_multimap_t* self,
 	ASSERT(val);
 	ASSERT(key);
 
-	cc_listIter_t* iter;
-	cc_mapIter_t*  miter;
-	cc_list_t*     list = NULL;
-
+	// check if the container already exists
+	cc_mapIter_t* miter;
 	miter = cc_map_findp(self->map, len, key);
 	if(miter)
 	{
-		list = (cc_list_t*) cc_map_val(miter);
+		return cc_multimap_insert(self,
+		                          (void*) cc_map_val(miter),
+		                          val);
 	}
 
-	// check if the list already exists
-	if(list && self->compare)
-	{
-		iter = cc_list_insertSorted(list, self->compare,
-		                            val);
-		if(iter == NULL)
-		{
-			return 0;
-		}
-
-		return 1;
-	}
-	else if(list)
-	{
-		iter = cc_list_append(list, NULL, val);
-		if(iter == NULL)
-		{
-			return 0;
-		}
-
-		return 1;
-	}
-
-	// create a new list and add to map
-	list = cc_list_new();
-	if(list == NULL)
+	// create a new container and add to map
+	void* container = cc_multimap_newContainer(self, val);
+	if(container == NULL)
 	{
 		return 0;
 	}
 
-	iter = cc_list_append(list, NULL, val);
-	if(iter == NULL)
-	{
-		goto fail_append;
-	}
-
-	if(cc_map_addp(self->map, (const void*) list, len,
+	if(cc_map_addp(self->map, (const void*) container, len,
 	               key) == NULL)
 	{
 		goto fail_add;
@@ -331,9 +512,7 @@ int cc_multimap_addp(cc_multimap_t* self,
 
 	// failure
 	fail_add:
-		cc_list_remove(list, &iter);
-	fail_append:
-		cc_list_delete(&list);
+		cc_multimap_deleteContainer(self, container);
 	return 0;
 }
 
@@ -345,53 +524,25 @@ int cc_multimap_add(cc_multimap_t* self,
 	ASSERT(val);
 	ASSERT(key);
 
-	cc_listIter_t* iter;
-	cc_mapIter_t*  miter;
-	cc_list_t*     list = NULL;
-
+	// check if the container already exists
+	cc_mapIter_t* miter;
 	miter = cc_map_find(self->map, key);
 	if(miter)
 	{
-		list = (cc_list_t*) cc_map_val(miter);
-	}
-
-	// check if the list already exists
-	if(list && self->compare)
-	{
-		iter = cc_list_insertSorted(list, self->compare,
-		                            val);
-		if(iter == NULL)
-		{
-			return 0;
-		}
-
-		return 1;
-	}
-	else if(list)
-	{
-		iter = cc_list_append(list, NULL, val);
-		if(iter == NULL)
-		{
-			return 0;
-		}
-
-		return 1;
+		return cc_multimap_insert(self,
+		                          (void*) cc_map_val(miter),
+		                          val);
 	}
 
-	// create a new list and add to map
-	list = cc_list_new();
-	if(list == NULL)
+	// create a new container and add to map
+	void* container = cc_multimap_newContainer(self, val);
+	if(container == NULL)
 	{
 		return 0;
 	}
 
-	iter = cc_list_append(list, NULL, val);
-	if(iter == NULL)
-	{
-		goto fail_append;
-	}
-
-	if(cc_map_add(self->map, (const void*) list, key) == NULL)
+	if(cc_map_add(self->map, (const void*) container,
+	              key) == NULL)
 	{
 		goto fail_add;
 	}
@@ -401,9 +552,7 @@ int cc_multimap_add(cc_multimap_t* self,
 
 	// failure
 	fail_add:
-		cc_list_remove(list, &iter);
-	fail_append:
-		cc_list_delete(&list);
+		cc_multimap_deleteContainer(self, container);
 	return 0;
 }
 
@@ -433,34 +582,44 @@ cc_multimap_remove(cc_multimap_t* self,
 
 	cc_multimapIter_t* mmiter = *_iter;
 
-	// remove iter from list;
-	cc_list_t* list;
-	list = (cc_list_t*)
-	       cc_map_val(mmiter->miter);
-	const void* data = cc_list_remove(list,
-	                                   &mmiter->iter);
+	// remove iter from container
+	const void* data;
+	int         size;
+	int         end;
+	void*       container;
+	container = (void*) cc_map_val(mmiter->miter);
+	if(mmiter->skiplist)
+	{
+		cc_skiplist_t* sl = (cc_skiplist_t*) container;
+		data = cc_skiplist_remove(sl, &mmiter->siter);
+		size = cc_skiplist_size(sl);
+		end  = (mmiter->siter == NULL);
+	}
+	else
+	{
+		cc_list_t* list = (cc_list_t*) container;
+		data = cc_list_remove(list, &mmiter->iter);
+		size = cc_list_size(list);
+		end  = (mmiter->iter == NULL);
+	}
 
-	// check if list is empty
+	// check if container is empty
 	// or if next iter is NULL
-	if(cc_list_size(list) == 0)
+	if(size == 0)
 	{
 		cc_map_remove(self->map, &mmiter->miter);
-		cc_list_delete(&list);
+		cc_multimap_deleteContainer(self, container);
 		if(mmiter->miter)
 		{
-			list = (cc_list_t*)
-			       cc_map_val(mmiter->miter);
-			mmiter->iter = cc_list_head(list);
+			cc_multimap_setIter(mmiter, self->skiplist);
 		}
 	}
-	else if(mmiter->iter == NULL)
+	else if(end)
 	{
 		mmiter->miter = cc_map_next(mmiter->miter);
 		if(mmiter->miter)
 		{
-			list = (cc_list_t*)
-			       cc_map_val(mmiter->miter);
-			mmiter->iter = cc_list_head(list);
+			cc_multimap_setIter(mmiter, self->skiplist);
 		}
 	}
 
@@ -26,54 +26,74 @@
 
 #include "cc_list.h"
 #include "cc_map.h"
+#include "cc_skiplist.h"
 
 typedef struct
 {
-	cc_mapIter_t*  miter;
-	cc_listIter_t* iter;
+	cc_mapIter_t*      miter;
+	cc_listIter_t*     iter;
+	cc_skiplistIter_t* siter;
+	int                skiplist;
 } cc_multimapIter_t;
 
 typedef struct
 {
 	cc_map_t*     map;
 	cc_listcmp_fn compare;
+	int           skiplist;
 } cc_multimap_t;
 
-cc_multimap_t*     cc_multimap_new(cc_listcmp_fn compare);
-void               cc_multimap_delete(cc_multimap_t** _self);
-void               cc_multimap_discard(cc_multimap_t* self);
-int                cc_multimap_size(const cc_multimap_t* self);
-size_t             cc_multimap_sizeof(const cc_multimap_t* self);
-cc_multimapIter_t* cc_multimap_head(const cc_multimap_t* self,
-                                    cc_multimapIter_t* mmiter);
-cc_multimapIter_t* cc_multimap_next(cc_multimapIter_t* mmiter);
-cc_multimapIter_t* cc_multimap_nextItem(cc_multimapIter_t* mmiter);
-cc_multimapIter_t* cc_multimap_nextList(cc_multimapIter_t* mmiter);
-const void*        cc_multimap_key(const cc_multimapIter_t* mmiter,
-                                   int* _len);
-const void*        cc_multimap_val(const cc_multimapIter_t* mmiter);
-const cc_list_t*   cc_multimap_list(const cc_multimapIter_t* mmiter);
-const cc_list_t*   cc_multimap_findp(const cc_multimap_t* self,
-                                     cc_multimapIter_t* mmiter,
-                                     int len,
-                                     const void* key);
-const cc_list_t*   cc_multimap_find(const cc_multimap_t* self,
-                                    cc_multimapIter_t* mmiter,
-                                    const char* key);
-const cc_list_t*   cc_multimap_findf(const cc_multimap_t* self,
-                                     cc_multimapIter_t* mmiter,
-                                     const char* fmt, ...);
-int                cc_multimap_addp(cc_multimap_t* self,
-                                    const void* val,
-                                    int len,
-                                    const void* key);
-int                cc_multimap_add(cc_multimap_t* self,
-                                   const void* val,
-                                   const char* key);
-int                cc_multimap_addf(cc_multimap_t* self,
-                                    const void* val,
-                                    const char* fmt, ...);
-const void*        cc_multimap_remove(cc_multimap_t* self,
-                                      cc_multimapIter_t** _mmiter);
+// multimaps created with cc_multimap_newSkiplist store the
+// values for each key in a cc_skiplist_t rather than a
+// sorted cc_list_t and must use the Skiplist variants of
+// the find and list functions
+cc_multimap_t*       cc_multimap_new(cc_listcmp_fn compare);
+cc_multimap_t*       cc_multimap_newSkiplist(cc_listcmp_fn compare);
+void                 cc_multimap_delete(cc_multimap_t** _self);
+void                 cc_multimap_discard(cc_multimap_t* self);
+int                  cc_multimap_size(const cc_multimap_t* self);
+size_t               cc_multimap_sizeof(const cc_multimap_t* self);
+cc_multimapIter_t*   cc_multimap_head(const cc_multimap_t* self,
+                                      cc_multimapIter_t* mmiter);
+cc_multimapIter_t*   cc_multimap_next(cc_multimapIter_t* mmiter);
+cc_multimapIter_t*   cc_multimap_nextItem(cc_multimapIter_t* mmiter);
+cc_multimapIter_t*   cc_multimap_nextList(cc_multimapIter_t* mmiter);
+const void*          cc_multimap_key(const cc_multimapIter_t* mmiter,
+                                     int* _len);
+const void*          cc_multimap_val(const cc_multimapIter_t* mmiter);
+const cc_list_t*     cc_multimap_list(const cc_multimapIter_t* mmiter);
+const cc_skiplist_t* cc_multimap_skiplist(const cc_multimapIter_t* mmiter);
+const cc_list_t*     cc_multimap_findp(const cc_multimap_t* self,
+                                       cc_multimapIter_t* mmiter,
+                                       int len,
+                                       const void* key);
+const cc_list_t*     cc_multimap_find(const cc_multimap_t* self,
+                                      cc_multimapIter_t* mmiter,
+                                      const char* key);
+const cc_list_t*     cc_multimap_findf(const cc_multimap_t* self,
+                                       cc_multimapIter_t* mmiter,
+                                       const char* fmt, ...);
+const cc_skiplist_t* cc_multimap_findpSkiplist(const cc_multimap_t* self,
+                                               cc_multimapIter_t* mmiter,
+                                               int len,
+                                               const void* key);
+const cc_skiplist_t* cc_multimap_findSkiplist(const cc_multimap_t* self,
+                                              cc_multimapIter_t* mmiter,
+                                              const char* key);
+const cc_skiplist_t* cc_multimap_findfSkiplist(const cc_multimap_t* self,
+                                               cc_multimapIter_t* mmiter,
+                                               const char* fmt, ...);
+int                  cc_multimap_addp(cc_multimap_t* self,
+                                      const void* val,
+                                      int len,
+                                      const void* key);
+int                  cc_multimap_add(cc_multimap_t* self,
+                                     const void* val,
+                                     const char* key);
+int                  cc_multimap_addf(cc_multimap_t* self,
+                                      const void* val,
+                                      const char* fmt, ...);
+const void*          cc_multimap_remove(cc_multimap_t* self,
+                                        cc_multimapIter_t** _mmiter);
 
 #endif
@@ -22,6 +22,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "cc_mumurhash3.h"
 
@@ -40,10 +41,14 @@
 
 // Block read - if your platform needs to do endian-swapping
 // or can only handle aligned reads, do the conversion here
+// memcpy is used so that unaligned keys are safe and it is
+// compiled to a single load on platforms which permit it
 FORCE_INLINE uint32_t
 getblock32 ( const uint32_t * p, int i )
 {
-  return p[i];
+  uint32_t b;
+  memcpy(&b, &p[i], sizeof(uint32_t));
+  return b;
 }
 
 // Finalization mix - force all bits of a hash block to
@@ -0,0 +1,472 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "cc"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_ptrmap.h"
+
+#define CC_PTRMAP_FLAG_CMALLOC 1
+
+#define CC_PTRMAP_CAPACITY 16
+
+// slot states
+#define CC_PTRMAP_EMPTY   0
+#define CC_PTRMAP_FULL    1
+#define CC_PTRMAP_DELETED 2
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static inline uint32_t
+cc_ptrmap_hash(const cc_ptrmap_t* self, uint64_t key)
+{
+	ASSERT(self);
+
+	// the high bits of the product mix every key bit which
+	// handles pointer keys whose low bits are always zero
+	return (uint32_t) ((key*0x9E3779B97F4A7C15ULL) >>
+	                   self->shift);
+}
+
+// returns the slot index for key and sets _found if the key
+// exists or otherwise returns the slot where key may be
+// added which prefers the first deleted slot on the probe
+static int
+cc_ptrmap_probe(const cc_ptrmap_t* self, uint64_t key,
+                int* _found)
+{
+	ASSERT(self);
+	ASSERT(_found);
+
+	uint32_t mask = self->capacity - 1;
+	uint32_t idx  = cc_ptrmap_hash(self, key);
+	int      del  = -1;
+
+	// the load factor ensures an empty slot exists
+	while(self->state[idx] != CC_PTRMAP_EMPTY)
+	{
+		if(self->state[idx] == CC_PTRMAP_FULL)
+		{
+			if(self->slots[idx].key == key)
+			{
+				*_found = 1;
+				return idx;
+			}
+		}
+		else if(del < 0)
+		{
+			del = idx;
+		}
+
+		idx = (idx + 1) & mask;
+	}
+
+	*_found = 0;
+	return (del >= 0) ? del : (int) idx;
+}
+
+static int
+cc_ptrmap_resize(cc_ptrmap_t* self, int capacity)
+{
+	ASSERT(self);
+	ASSERT(capacity >= CC_PTRMAP_CAPACITY);
+
+	size_t size = capacity*(sizeof(cc_ptrmapSlot_t) + 1);
+
+	cc_ptrmapSlot_t* slots;
+	if(self->flags & CC_PTRMAP_FLAG_CMALLOC)
+	{
+		slots = (cc_ptrmapSlot_t*) malloc(size);
+	}
+	else
+	{
+		slots = (cc_ptrmapSlot_t*)
+		        MALLOC_TAG(CC_MEMTAG_MAP, size);
+	}
+
+	if(slots == NULL)
+	{
+		LOGE("MALLOC_TAG failed");
+		return 0;
+	}
+
+	uint8_t* state = (uint8_t*) &slots[capacity];
+	memset((void*) state, CC_PTRMAP_EMPTY, capacity);
+
+	cc_ptrmapSlot_t* slots1    = self->slots;
+	uint8_t*         state1    = self->state;
+	int              capacity1 = self->capacity;
+
+	int shift = 64;
+	int n     = capacity;
+	while(n > 1)
+	{
+		--shift;
+		n >>= 1;
+	}
+
+	self->slots    = slots;
+	self->state    = state;
+	self->capacity = capacity;
+	self->shift    = shift;
+	self->deleted  = 0;
+
+	// reinsert the full slots
+	int i;
+	int j;
+	int found;
+	for(i = 0; i < capacity1; ++i)
+	{
+		if(state1[i] != CC_PTRMAP_FULL)
+		{
+			continue;
+		}
+
+		j = cc_ptrmap_probe(self, slots1[i].key, &found);
+		state[j] = CC_PTRMAP_FULL;
+		slots[j] = slots1[i];
+	}
+
+	if(self->flags & CC_PTRMAP_FLAG_CMALLOC)
+	{
+		free(slots1);
+	}
+	else
+	{
+		FREE(slots1);
+	}
+
+	return 1;
+}
+
+static int cc_ptrmap_grow(cc_ptrmap_t* self)
+{
+	ASSERT(self);
+
+	// maximum load factor of 3/4
+	int count = self->size + self->deleted + 1;
+	if(count <= self->capacity - self->capacity/4)
+	{
+		return 1;
+	}
+
+	// rehash in place to drop deleted slots unless the
+	// map is more than half full
+	int capacity = self->capacity;
+	if(self->size + 1 > capacity/2)
+	{
+		capacity *= 2;
+	}
+
+	return cc_ptrmap_resize(self, capacity);
+}
+
+static cc_ptrmapIter_t*
+cc_ptrmap_scan(const cc_ptrmap_t* self, int idx)
+{
+	ASSERT(self);
+
+	// find the next full slot
+	while(idx < self->capacity)
+	{
+		if(self->state[idx] == CC_PTRMAP_FULL)
+		{
+			return &self->slots[idx];
+		}
+		++idx;
+	}
+
+	return NULL;
+}
+
+static cc_ptrmap_t* cc_ptrmap_newFlags(int flags)
+{
+	cc_ptrmap_t* self;
+	if(flags & CC_PTRMAP_FLAG_CMALLOC)
+	{
+		self = (cc_ptrmap_t*)
+		       calloc(1, sizeof(cc_ptrmap_t));
+	}
+	else
+	{
+		self = (cc_ptrmap_t*)
+		       CALLOC_TAG(CC_MEMTAG_MAP, 1, sizeof(cc_ptrmap_t));
+	}
+
+	if(self == NULL)
+	{
+		LOGE("CALLOC_TAG failed");
+		return NULL;
+	}
+
+	self->flags = flags;
+
+	if(cc_ptrmap_resize(self, CC_PTRMAP_CAPACITY) == 0)
+	{
+		goto fail_resize;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_resize:
+	{
+		if(flags & CC_PTRMAP_FLAG_CMALLOC)
+		{
+			free(self);
+		}
+		else
+		{
+			FREE(self);
+		}
+	}
+	return NULL;
+}
+
+/***********************************************************
+* protected                                                *
+***********************************************************/
+
+// the newCMalloc protected function is intended to be
+// used by cc_memory debug feature which depends on
+// cc_ptrmap but cannot use the cc_memory tracking without
+// deadlocks
+cc_ptrmap_t* cc_ptrmap_newCMalloc(void)
+{
+	return cc_ptrmap_newFlags(CC_PTRMAP_FLAG_CMALLOC);
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_ptrmap_t* cc_ptrmap_new(void)
+{
+	return cc_ptrmap_newFlags(0);
+}
+
+void cc_ptrmap_delete(cc_ptrmap_t** _self)
+{
+	ASSERT(_self);
+
+	cc_ptrmap_t* self = *_self;
+	if(self)
+	{
+		if(self->flags & CC_PTRMAP_FLAG_CMALLOC)
+		{
+			free(self->slots);
+			free(self);
+		}
+		else
+		{
+			FREE(self->slots);
+			FREE(self);
+		}
+		*_self = NULL;
+	}
+}
+
+void cc_ptrmap_discard(cc_ptrmap_t* self)
+{
+	ASSERT(self);
+
+	memset((void*) self->state, CC_PTRMAP_EMPTY,
+	       self->capacity);
+	self->size    = 0;
+	self->deleted = 0;
+}
+
+int cc_ptrmap_size(const cc_ptrmap_t* self)
+{
+	ASSERT(self);
+
+	return self->size;
+}
+
+size_t cc_ptrmap_sizeof(const cc_ptrmap_t* self)
+{
+	ASSERT(self);
+
+	// sizeof map + slots + state
+	size_t size = sizeof(cc_ptrmap_t);
+	size += self->capacity*(sizeof(cc_ptrmapSlot_t) + 1);
+	return size;
+}
+
+cc_ptrmapIter_t*
+cc_ptrmap_head(const cc_ptrmap_t* self)
+{
+	ASSERT(self);
+
+	return cc_ptrmap_scan(self, 0);
+}
+
+cc_ptrmapIter_t*
+cc_ptrmap_next(const cc_ptrmap_t* self,
+               cc_ptrmapIter_t* miter)
+{
+	ASSERT(self);
+	ASSERT(miter);
+
+	return cc_ptrmap_scan(self, miter - self->slots + 1);
+}
+
+uint64_t cc_ptrmap_key(const cc_ptrmapIter_t* miter)
+{
+	ASSERT(miter);
+
+	return miter->key;
+}
+
+const void* cc_ptrmap_keyp(const cc_ptrmapIter_t* miter)
+{
+	ASSERT(miter);
+
+	return (const void*) (uintptr_t) miter->key;
+}
+
+const void* cc_ptrmap_val(const cc_ptrmapIter_t* miter)
+{
+	ASSERT(miter);
+
+	return miter->val;
+}
+
+cc_ptrmapIter_t*
+cc_ptrmap_find(const cc_ptrmap_t* self, uint64_t key)
+{
+	ASSERT(self);
+
+	int found;
+	int idx = cc_ptrmap_probe(self, key, &found);
+	if(found == 0)
+	{
+		return NULL;
+	}
+
+	return &self->slots[idx];
+}
+
+cc_ptrmapIter_t*
+cc_ptrmap_findp(const cc_ptrmap_t* self, const void* key)
+{
+	ASSERT(self);
+
+	return cc_ptrmap_find(self, (uint64_t) (uintptr_t) key);
+}
+
+cc_ptrmapIter_t*
+cc_ptrmap_add(cc_ptrmap_t* self, const void* val,
+              uint64_t key)
+{
+	// val may be NULL
+	ASSERT(self);
+
+	int found;
+	cc_ptrmap_probe(self, key, &found);
+	if(found)
+	{
+		return NULL;
+	}
+
+	if(cc_ptrmap_grow(self) == 0)
+	{
+		return NULL;
+	}
+
+	// probe again since grow may have rehashed the slots
+	int idx = cc_ptrmap_probe(self, key, &found);
+	if(self->state[idx] == CC_PTRMAP_DELETED)
+	{
+		--self->deleted;
+	}
+	self->state[idx] = CC_PTRMAP_FULL;
+
+	cc_ptrmapSlot_t* slot = &self->slots[idx];
+	slot->key = key;
+	slot->val = val;
+	++self->size;
+
+	return slot;
+}
+
+cc_ptrmapIter_t*
+cc_ptrmap_addp(cc_ptrmap_t* self, const void* val,
+               const void* key)
+{
+	// val may be NULL
+	ASSERT(self);
+
+	return cc_ptrmap_add(self, val, (uint64_t) (uintptr_t) key);
+}
+
+const void*
+cc_ptrmap_remove(cc_ptrmap_t* self,
+                 cc_ptrmapIter_t** _miter)
+{
+	ASSERT(self);
+	ASSERT(_miter);
+	ASSERT(*_miter);
+
+	cc_ptrmapIter_t* miter = *_miter;
+	const void*      val   = miter->val;
+
+	uint32_t mask = self->capacity - 1;
+	uint32_t idx  = miter - self->slots;
+	ASSERT(self->state[idx] == CC_PTRMAP_FULL);
+
+	// a probe sequence never continues past an empty slot
+	// so the slot may be emptied rather than marked as
+	// deleted when the following slot is empty and the
+	// deleted slots which precede it may be emptied too
+	if(self->state[(idx + 1) & mask] == CC_PTRMAP_EMPTY)
+	{
+		uint32_t i = idx;
+		self->state[i] = CC_PTRMAP_EMPTY;
+
+		i = (i - 1) & mask;
+		while(self->state[i] == CC_PTRMAP_DELETED)
+		{
+			self->state[i] = CC_PTRMAP_EMPTY;
+			--self->deleted;
+			i = (i - 1) & mask;
+		}
+	}
+	else
+	{
+		self->state[idx] = CC_PTRMAP_DELETED;
+		++self->deleted;
+	}
+	--self->size;
+
+	// update miter
+	*_miter = cc_ptrmap_scan(self, idx + 1);
+
+	return val;
+}
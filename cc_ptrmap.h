@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_ptrmap_H
+#define cc_ptrmap_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+// The ptrmap is an open addressing hash map specialized for
+// 64-bit integer and pointer keys. Keys are stored inline
+// in a flat slot array and are hashed with a multiplicative
+// (Fibonacci) hash. Adding an entry may rehash the slot
+// array which invalidates all iterators while removing an
+// entry does not move the remaining entries.
+
+typedef struct
+{
+	uint64_t    key;
+	const void* val;
+} cc_ptrmapSlot_t;
+
+typedef cc_ptrmapSlot_t cc_ptrmapIter_t;
+
+typedef struct
+{
+	int flags;
+	int size;
+	int deleted;
+	int capacity;
+	int shift;
+
+	// slots and state share one allocation
+	cc_ptrmapSlot_t* slots;
+	uint8_t*         state;
+} cc_ptrmap_t;
+
+cc_ptrmap_t*     cc_ptrmap_new(void);
+void             cc_ptrmap_delete(cc_ptrmap_t** _self);
+void             cc_ptrmap_discard(cc_ptrmap_t* self);
+int              cc_ptrmap_size(const cc_ptrmap_t* self);
+size_t           cc_ptrmap_sizeof(const cc_ptrmap_t* self);
+cc_ptrmapIter_t* cc_ptrmap_head(const cc_ptrmap_t* self);
+cc_ptrmapIter_t* cc_ptrmap_next(const cc_ptrmap_t* self,
+                                cc_ptrmapIter_t* miter);
+uint64_t         cc_ptrmap_key(const cc_ptrmapIter_t* miter);
+const void*      cc_ptrmap_keyp(const cc_ptrmapIter_t* miter);
+const void*      cc_ptrmap_val(const cc_ptrmapIter_t* miter);
+cc_ptrmapIter_t* cc_ptrmap_find(const cc_ptrmap_t* self,
+                                uint64_t key);
+cc_ptrmapIter_t* cc_ptrmap_findp(const cc_ptrmap_t* self,
+                                 const void* key);
+cc_ptrmapIter_t* cc_ptrmap_add(cc_ptrmap_t* self,
+                               const void* val,
+                               uint64_t key);
+cc_ptrmapIter_t* cc_ptrmap_addp(cc_ptrmap_t* self,
+                                const void* val,
+                                const void* key);
+const void*      cc_ptrmap_remove(cc_ptrmap_t* self,
+                                  cc_ptrmapIter_t** _miter);
+
+#endif
@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+
+#define LOG_TAG "cc"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_skiplist.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int cc_skiplist_randomLevel(cc_skiplist_t* self)
+{
+	ASSERT(self);
+
+	// xorshift32
+	unsigned int r = self->seed;
+	r ^= r << 13;
+	r ^= r >> 17;
+	r ^= r << 5;
+	self->seed = r;
+
+	// promote with probability 1/4 per level
+	int level = 1;
+	while((level < CC_SKIPLIST_LEVELS) && ((r & 3) == 0))
+	{
+		++level;
+		r >>= 2;
+	}
+
+	return level;
+}
+
+// find the first element greater than or equal to data
+// (or greater than data when upper is set) and optionally
+// the link slots which point to it at each level
+static cc_skiplistIter_t*
+cc_skiplist_search(const cc_skiplist_t* self,
+                   const void* data, int upper,
+                   cc_skiplistIter_t** _prev,
+                   cc_skiplistIter_t*** slots)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	cc_skiplistIter_t*  prev = NULL;
+	cc_skiplistIter_t** next;
+	next = (cc_skiplistIter_t**) self->head;
+
+	int i;
+	for(i = self->level - 1; i >= 0; --i)
+	{
+		cc_skiplistIter_t* iter = next[i];
+		while(iter)
+		{
+			int cmp = (*self->compare)(data, iter->data);
+			if((cmp < 0) || ((cmp == 0) && (upper == 0)))
+			{
+				break;
+			}
+
+			prev = iter;
+			next = iter->next;
+			iter = next[i];
+		}
+
+		if(slots)
+		{
+			slots[i] = &next[i];
+		}
+	}
+
+	if(_prev)
+	{
+		*_prev = prev;
+	}
+
+	return next[0];
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_skiplist_t* cc_skiplist_new(cc_listcmp_fn compare)
+{
+	ASSERT(compare);
+
+	cc_skiplist_t* self;
+	self = (cc_skiplist_t*)
+	       CALLOC_TAG(CC_MEMTAG_SKIPLIST, 1,
+	                  sizeof(cc_skiplist_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC_TAG failed");
+		return NULL;
+	}
+
+	self->level   = 1;
+	self->seed    = 0x2545F491;
+	self->compare = compare;
+
+	return self;
+}
+
+void cc_skiplist_delete(cc_skiplist_t** _self)
+{
+	ASSERT(_self);
+
+	cc_skiplist_t* self = *_self;
+	if(self)
+	{
+		if(self->size > 0)
+		{
+			LOGE("memory leak detected: size=%i", self->size);
+		}
+
+		cc_skiplist_discard(self);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+void cc_skiplist_discard(cc_skiplist_t* self)
+{
+	ASSERT(self);
+
+	cc_skiplistIter_t* iter = self->head[0];
+	while(iter)
+	{
+		cc_skiplistIter_t* next = iter->next[0];
+		FREE(iter);
+		iter = next;
+	}
+
+	int i;
+	for(i = 0; i < CC_SKIPLIST_LEVELS; ++i)
+	{
+		self->head[i] = NULL;
+	}
+
+	self->size  = 0;
+	self->level = 1;
+	self->links = 0;
+	self->tail  = NULL;
+}
+
+int cc_skiplist_size(const cc_skiplist_t* self)
+{
+	ASSERT(self);
+
+	return self->size;
+}
+
+size_t cc_skiplist_sizeof(const cc_skiplist_t* self)
+{
+	ASSERT(self);
+
+	return sizeof(cc_skiplist_t) +
+	       self->size*sizeof(cc_skiplistIter_t) +
+	       self->links*sizeof(cc_skiplistIter_t*);
+}
+
+const void* cc_skiplist_peekHead(const cc_skiplist_t* self)
+{
+	ASSERT(self);
+
+	if(self->head[0] == NULL)
+	{
+		return NULL;
+	}
+
+	return self->head[0]->data;
+}
+
+const void* cc_skiplist_peekTail(const cc_skiplist_t* self)
+{
+	ASSERT(self);
+
+	if(self->tail == NULL)
+	{
+		return NULL;
+	}
+
+	return self->tail->data;
+}
+
+const void* cc_skiplist_peekIter(const cc_skiplistIter_t* iter)
+{
+	ASSERT(iter);
+
+	return iter->data;
+}
+
+cc_skiplistIter_t* cc_skiplist_head(const cc_skiplist_t* self)
+{
+	ASSERT(self);
+
+	return self->head[0];
+}
+
+cc_skiplistIter_t* cc_skiplist_tail(const cc_skiplist_t* self)
+{
+	ASSERT(self);
+
+	return self->tail;
+}
+
+cc_skiplistIter_t* cc_skiplist_next(cc_skiplistIter_t* iter)
+{
+	ASSERT(iter);
+
+	return iter->next[0];
+}
+
+cc_skiplistIter_t* cc_skiplist_prev(cc_skiplistIter_t* iter)
+{
+	ASSERT(iter);
+
+	return iter->prev;
+}
+
+cc_skiplistIter_t*
+cc_skiplist_find(const cc_skiplist_t* self, const void* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	// find the first equal element
+	cc_skiplistIter_t* iter;
+	iter = cc_skiplist_search(self, data, 0, NULL, NULL);
+	if(iter && ((*self->compare)(data, iter->data) == 0))
+	{
+		return iter;
+	}
+
+	return NULL;
+}
+
+cc_skiplistIter_t*
+cc_skiplist_lowerBound(const cc_skiplist_t* self,
+                       const void* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	return cc_skiplist_search(self, data, 0, NULL, NULL);
+}
+
+cc_skiplistIter_t*
+cc_skiplist_upperBound(const cc_skiplist_t* self,
+                       const void* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	return cc_skiplist_search(self, data, 1, NULL, NULL);
+}
+
+cc_skiplistIter_t*
+cc_skiplist_insert(cc_skiplist_t* self, const void* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	int level = cc_skiplist_randomLevel(self);
+
+	cc_skiplistIter_t* iter;
+	iter = (cc_skiplistIter_t*)
+	       MALLOC_TAG(CC_MEMTAG_SKIPLIST,
+	                  sizeof(cc_skiplistIter_t) +
+	                  level*sizeof(cc_skiplistIter_t*));
+	if(iter == NULL)
+	{
+		LOGE("MALLOC_TAG failed");
+		return NULL;
+	}
+
+	// insert after any equal elements
+	cc_skiplistIter_t*  prev;
+	cc_skiplistIter_t** slots[CC_SKIPLIST_LEVELS];
+	cc_skiplist_search(self, data, 1, &prev, slots);
+
+	// raise the list level
+	int i;
+	for(i = self->level; i < level; ++i)
+	{
+		slots[i] = &self->head[i];
+	}
+	if(level > self->level)
+	{
+		self->level = level;
+	}
+
+	// link the element
+	iter->data  = data;
+	iter->prev  = prev;
+	iter->level = level;
+	for(i = 0; i < level; ++i)
+	{
+		iter->next[i] = *slots[i];
+		*slots[i]     = iter;
+	}
+
+	if(iter->next[0])
+	{
+		iter->next[0]->prev = iter;
+	}
+	else
+	{
+		self->tail = iter;
+	}
+
+	++self->size;
+	self->links += level;
+
+	return iter;
+}
+
+const void*
+cc_skiplist_remove(cc_skiplist_t* self,
+                   cc_skiplistIter_t** _iter)
+{
+	ASSERT(self);
+	ASSERT(_iter);
+	ASSERT(*_iter);
+
+	cc_skiplistIter_t* iter = *_iter;
+
+	// find the slots which point to the first equal element
+	// and advance past any equal elements preceding iter
+	cc_skiplistIter_t** slots[CC_SKIPLIST_LEVELS];
+	cc_skiplist_search(self, iter->data, 0, NULL, slots);
+
+	int i;
+	for(i = 0; i < iter->level; ++i)
+	{
+		while(*slots[i] != iter)
+		{
+			ASSERT(*slots[i]);
+			slots[i] = &(*slots[i])->next[i];
+		}
+		*slots[i] = iter->next[i];
+	}
+
+	if(iter->next[0])
+	{
+		iter->next[0]->prev = iter->prev;
+	}
+	else
+	{
+		self->tail = iter->prev;
+	}
+
+	// lower the list level
+	while((self->level > 1) &&
+	      (self->head[self->level - 1] == NULL))
+	{
+		--self->level;
+	}
+
+	--self->size;
+	self->links -= iter->level;
+
+	const void* data = iter->data;
+	*_iter = iter->next[0];
+	FREE(iter);
+
+	return data;
+}
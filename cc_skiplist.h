@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_skiplist_H
+#define cc_skiplist_H
+
+#include <stddef.h>
+
+#include "cc_list.h"
+
+// The skiplist keeps its elements ordered by the compare
+// function with O(log n) expected insert, find and remove.
+// Equal elements are kept in insertion order. A range
+// [a, b) may be iterated from cc_skiplist_lowerBound(a)
+// until cc_skiplist_lowerBound(b) and a range [a, b] may be
+// iterated until cc_skiplist_upperBound(b). The elements
+// are owned by the caller.
+
+#define CC_SKIPLIST_LEVELS 16
+
+typedef struct cc_skiplistIter_s
+{
+	const void*               data;
+	struct cc_skiplistIter_s* prev;
+	int                       level;
+	struct cc_skiplistIter_s* next[];
+} cc_skiplistIter_t;
+
+typedef struct
+{
+	int                size;
+	int                level;
+	int                links;
+	unsigned int       seed;
+	cc_listcmp_fn      compare;
+	cc_skiplistIter_t* tail;
+	cc_skiplistIter_t* head[CC_SKIPLIST_LEVELS];
+} cc_skiplist_t;
+
+cc_skiplist_t*     cc_skiplist_new(cc_listcmp_fn compare);
+void               cc_skiplist_delete(cc_skiplist_t** _self);
+void               cc_skiplist_discard(cc_skiplist_t* self);
+int                cc_skiplist_size(const cc_skiplist_t* self);
+size_t             cc_skiplist_sizeof(const cc_skiplist_t* self);
+const void*        cc_skiplist_peekHead(const cc_skiplist_t* self);
+const void*        cc_skiplist_peekTail(const cc_skiplist_t* self);
+const void*        cc_skiplist_peekIter(const cc_skiplistIter_t* iter);
+cc_skiplistIter_t* cc_skiplist_head(const cc_skiplist_t* self);
+cc_skiplistIter_t* cc_skiplist_tail(const cc_skiplist_t* self);
+cc_skiplistIter_t* cc_skiplist_next(cc_skiplistIter_t* iter);
+cc_skiplistIter_t* cc_skiplist_prev(cc_skiplistIter_t* iter);
+cc_skiplistIter_t* cc_skiplist_find(const cc_skiplist_t* self,
+                                    const void* data);
+cc_skiplistIter_t* cc_skiplist_lowerBound(const cc_skiplist_t* self,
+                                          const void* data);
+cc_skiplistIter_t* cc_skiplist_upperBound(const cc_skiplist_t* self,
+                                          const void* data);
+cc_skiplistIter_t* cc_skiplist_insert(cc_skiplist_t* self,
+                                      const void* data);
+const void*        cc_skiplist_remove(cc_skiplist_t* self,
+                                      cc_skiplistIter_t** _iter);
+
+#endif
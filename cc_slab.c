@@ -0,0 +1,494 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "cc"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_slab.h"
+
+#ifndef CC_SLAB_BYPASS
+
+#define CC_SLAB_PAGE_SIZE 4096
+#define CC_SLAB_MAX_SIZE  256
+#define CC_SLAB_CLASSES   12
+#define CC_SLAB_MAGAZINE  64
+#define CC_SLAB_BATCH     32
+
+// a size class retains up to CC_SLAB_RETAIN pages once all
+// of its objs have been freed so that alloc/free cycles do
+// not need to allocate a new page each time
+#define CC_SLAB_RETAIN 1
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+typedef struct cc_slabObj_s
+{
+	struct cc_slabObj_s* next;
+} cc_slabObj_t;
+
+typedef struct cc_slabPage_s
+{
+	struct cc_slabPage_s* next;
+	// uint8_t            objs[];
+} cc_slabPage_t;
+
+typedef struct
+{
+	size_t size;
+
+	// objects held by callers (e.g. not in the global pool
+	// or a magazine)
+	atomic_size_t refcount;
+
+	// global pool
+	size_t          count;
+	size_t          total;
+	cc_slabObj_t*   objs;
+	cc_slabPage_t*  pages;
+	atomic_size_t   page_count;
+	pthread_mutex_t mutex;
+} cc_slabClass_t;
+
+typedef struct
+{
+	int           count;
+	cc_slabObj_t* objs;
+} cc_slabMagazine_t;
+
+typedef struct
+{
+	cc_slabMagazine_t magazine[CC_SLAB_CLASSES];
+} cc_slabCache_t;
+
+#define CC_SLAB_CLASS(sz) \
+	{ .size=sz, .mutex=PTHREAD_MUTEX_INITIALIZER }
+
+static cc_slabClass_t g_slab_class[CC_SLAB_CLASSES] =
+{
+	CC_SLAB_CLASS(16),  CC_SLAB_CLASS(32),
+	CC_SLAB_CLASS(48),  CC_SLAB_CLASS(64),
+	CC_SLAB_CLASS(80),  CC_SLAB_CLASS(96),
+	CC_SLAB_CLASS(112), CC_SLAB_CLASS(128),
+	CC_SLAB_CLASS(160), CC_SLAB_CLASS(192),
+	CC_SLAB_CLASS(224), CC_SLAB_CLASS(256),
+};
+
+static pthread_once_t g_slab_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  g_slab_key;
+
+static _Thread_local cc_slabCache_t* g_slab_cache = NULL;
+
+static int cc_slab_index(size_t size)
+{
+	if(size <= 128)
+	{
+		return (size <= 16) ? 0 : (int) ((size - 1)/16);
+	}
+
+	return 8 + (int) ((size - 129)/32);
+}
+
+static void
+cc_slabClass_addPage(cc_slabClass_t* self, cc_slabPage_t* page)
+{
+	ASSERT(self);
+	ASSERT(page);
+
+	page->next  = self->pages;
+	self->pages = page;
+	atomic_fetch_add_explicit(&self->page_count, 1,
+	                          memory_order_relaxed);
+
+	// insert objs to the list of free objs
+	uint8_t* base = ((uint8_t*) page) + sizeof(cc_slabPage_t);
+	size_t   n    = (CC_SLAB_PAGE_SIZE - sizeof(cc_slabPage_t))/
+	                self->size;
+
+	size_t i;
+	for(i = 0; i < n; ++i)
+	{
+		cc_slabObj_t* obj;
+		obj        = (cc_slabObj_t*) (base + i*self->size);
+		obj->next  = self->objs;
+		self->objs = obj;
+	}
+
+	self->count += n;
+	self->total += n;
+}
+
+static int cc_slabClass_grow(cc_slabClass_t* self)
+{
+	ASSERT(self);
+
+	cc_slabPage_t* page;
+	page = (cc_slabPage_t*) MALLOC(CC_SLAB_PAGE_SIZE);
+	if(page == NULL)
+	{
+		LOGE("MALLOC failed");
+		return 0;
+	}
+
+	cc_slabClass_addPage(self, page);
+
+	return 1;
+}
+
+static void
+cc_slabClass_trimLocked(cc_slabClass_t* self, size_t retain)
+{
+	ASSERT(self);
+
+	// free the pages which exceed retain when no objs are
+	// in use
+	if((self->count != self->total) ||
+	   (atomic_load(&self->refcount) != 0) ||
+	   (atomic_load(&self->page_count) <= retain))
+	{
+		return;
+	}
+
+	cc_slabPage_t* pages = self->pages;
+	self->objs  = NULL;
+	self->pages = NULL;
+	self->count = 0;
+	self->total = 0;
+	atomic_store(&self->page_count, 0);
+
+	// rebuild the list of free objs from the retained pages
+	cc_slabPage_t* page;
+	while(pages)
+	{
+		page  = pages;
+		pages = pages->next;
+		if(atomic_load(&self->page_count) < retain)
+		{
+			cc_slabClass_addPage(self, page);
+		}
+		else
+		{
+			FREE(page);
+		}
+	}
+}
+
+static void
+cc_slabClass_trim(cc_slabClass_t* self, size_t retain)
+{
+	ASSERT(self);
+
+	pthread_mutex_lock(&self->mutex);
+	cc_slabClass_trimLocked(self, retain);
+	pthread_mutex_unlock(&self->mutex);
+}
+
+static void
+cc_slabClass_put(cc_slabClass_t* self,
+                 cc_slabMagazine_t* magazine, int count)
+{
+	ASSERT(self);
+	ASSERT(magazine);
+
+	if(count == 0)
+	{
+		return;
+	}
+
+	// find the tail of the batch
+	cc_slabObj_t* head = magazine->objs;
+	cc_slabObj_t* tail = head;
+	int i;
+	for(i = 1; i < count; ++i)
+	{
+		tail = tail->next;
+	}
+	magazine->objs   = tail->next;
+	magazine->count -= count;
+
+	pthread_mutex_lock(&self->mutex);
+	tail->next   = self->objs;
+	self->objs   = head;
+	self->count += count;
+	pthread_mutex_unlock(&self->mutex);
+}
+
+static int
+cc_slabClass_get(cc_slabClass_t* self,
+                 cc_slabMagazine_t* magazine)
+{
+	ASSERT(self);
+	ASSERT(magazine);
+
+	pthread_mutex_lock(&self->mutex);
+
+	// larger size classes may need multiple pages
+	while(self->count < CC_SLAB_BATCH)
+	{
+		if(cc_slabClass_grow(self) == 0)
+		{
+			pthread_mutex_unlock(&self->mutex);
+			return 0;
+		}
+	}
+
+	int i;
+	for(i = 0; i < CC_SLAB_BATCH; ++i)
+	{
+		cc_slabObj_t* obj = self->objs;
+		self->objs      = obj->next;
+		obj->next       = magazine->objs;
+		magazine->objs  = obj;
+	}
+	self->count     -= CC_SLAB_BATCH;
+	magazine->count += CC_SLAB_BATCH;
+
+	pthread_mutex_unlock(&self->mutex);
+
+	return 1;
+}
+
+static void cc_slabCache_flush(cc_slabCache_t* self)
+{
+	ASSERT(self);
+
+	int i;
+	for(i = 0; i < CC_SLAB_CLASSES; ++i)
+	{
+		cc_slabClass_t*    slab     = &g_slab_class[i];
+		cc_slabMagazine_t* magazine = &self->magazine[i];
+		cc_slabClass_put(slab, magazine, magazine->count);
+		cc_slabClass_trim(slab, 0);
+	}
+}
+
+static void cc_slabCache_destruct(void* arg)
+{
+	ASSERT(arg);
+
+	cc_slabCache_t* self = (cc_slabCache_t*) arg;
+
+	// return the magazines of an exiting thread
+	cc_slabCache_flush(self);
+	free(self);
+	g_slab_cache = NULL;
+}
+
+static void cc_slabCache_once(void)
+{
+	if(pthread_key_create(&g_slab_key,
+	                      cc_slabCache_destruct) != 0)
+	{
+		LOGE("pthread_key_create failed");
+	}
+}
+
+static cc_slabCache_t* cc_slabCache_get(void)
+{
+	if(g_slab_cache)
+	{
+		return g_slab_cache;
+	}
+
+	pthread_once(&g_slab_once, cc_slabCache_once);
+
+	// the cache is internal state which is not included
+	// in the MEMCOUNT/MEMSIZE totals
+	cc_slabCache_t* self;
+	self = (cc_slabCache_t*) calloc(1, sizeof(cc_slabCache_t));
+	if(self == NULL)
+	{
+		LOGE("calloc failed");
+		return NULL;
+	}
+
+	if(pthread_setspecific(g_slab_key, (const void*) self) != 0)
+	{
+		LOGE("pthread_setspecific failed");
+		free(self);
+		return NULL;
+	}
+
+	g_slab_cache = self;
+
+	return self;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+void* cc_slab_alloc(size_t size)
+{
+	if(size > CC_SLAB_MAX_SIZE)
+	{
+		return MALLOC(size);
+	}
+
+	cc_slabCache_t* cache = cc_slabCache_get();
+	if(cache == NULL)
+	{
+		return NULL;
+	}
+
+	int                idx      = cc_slab_index(size);
+	cc_slabClass_t*    slab     = &g_slab_class[idx];
+	cc_slabMagazine_t* magazine = &cache->magazine[idx];
+	if(magazine->count == 0)
+	{
+		if(cc_slabClass_get(slab, magazine) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	cc_slabObj_t* obj = magazine->objs;
+	magazine->objs = obj->next;
+	--magazine->count;
+
+	atomic_fetch_add_explicit(&slab->refcount, 1,
+	                          memory_order_relaxed);
+
+	return (void*) obj;
+}
+
+void* cc_slab_calloc(size_t size)
+{
+	void* ptr = cc_slab_alloc(size);
+	if(ptr)
+	{
+		memset(ptr, 0, size);
+	}
+
+	return ptr;
+}
+
+void cc_slab_free(void* ptr, size_t size)
+{
+	// ptr may be NULL
+
+	if(ptr == NULL)
+	{
+		return;
+	}
+	else if(size > CC_SLAB_MAX_SIZE)
+	{
+		FREE(ptr);
+		return;
+	}
+
+	int                idx   = cc_slab_index(size);
+	cc_slabClass_t*    slab  = &g_slab_class[idx];
+	cc_slabCache_t*    cache = cc_slabCache_get();
+	cc_slabMagazine_t  tmp   = { .count=0, .objs=NULL };
+	cc_slabMagazine_t* magazine;
+	if(cache)
+	{
+		magazine = &cache->magazine[idx];
+	}
+	else
+	{
+		// return the obj directly to the global pool
+		magazine = &tmp;
+	}
+
+	cc_slabObj_t* obj = (cc_slabObj_t*) ptr;
+	obj->next      = magazine->objs;
+	magazine->objs = obj;
+	++magazine->count;
+
+	// return the magazine to allow the excess pages to be
+	// freed when the last obj is freed
+	size_t refcount;
+	refcount = atomic_fetch_sub_explicit(&slab->refcount, 1,
+	                                     memory_order_relaxed);
+	if((refcount == 1) &&
+	   (atomic_load_explicit(&slab->page_count,
+	                         memory_order_relaxed) > CC_SLAB_RETAIN))
+	{
+		cc_slabClass_put(slab, magazine, magazine->count);
+		cc_slabClass_trim(slab, CC_SLAB_RETAIN);
+	}
+	else if(magazine->count > CC_SLAB_MAGAZINE)
+	{
+		cc_slabClass_put(slab, magazine, CC_SLAB_BATCH);
+	}
+	else if(magazine == &tmp)
+	{
+		cc_slabClass_put(slab, magazine, magazine->count);
+	}
+}
+
+void* cc_slab_allocTag(int tag, size_t size)
+{
+	void* ptr = cc_slab_alloc(size);
+	if(ptr)
+	{
+		cc_memtag_inc(tag, size);
+	}
+
+	return ptr;
+}
+
+void* cc_slab_callocTag(int tag, size_t size)
+{
+	void* ptr = cc_slab_calloc(size);
+	if(ptr)
+	{
+		cc_memtag_inc(tag, size);
+	}
+
+	return ptr;
+}
+
+void cc_slab_freeTag(int tag, void* ptr, size_t size)
+{
+	// ptr may be NULL
+
+	if(ptr)
+	{
+		cc_memtag_dec(tag, size);
+		cc_slab_free(ptr, size);
+	}
+}
+
+#endif // CC_SLAB_BYPASS
+
+void cc_slab_flush(void)
+{
+	// return the magazines of the calling thread and free
+	// the slabs of size classes with no objs in use
+	#ifndef CC_SLAB_BYPASS
+	if(g_slab_cache)
+	{
+		cc_slabCache_flush(g_slab_cache);
+	}
+	#endif
+}
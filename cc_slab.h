@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_slab_H
+#define cc_slab_H
+
+#include <stddef.h>
+
+#include "cc_memory.h"
+
+// The slab allocator serves small fixed-size objects from
+// page-sized slabs which are partitioned into size classes.
+// Each thread caches free objects in a per-thread magazine
+// so that most alloc/free calls do not require a lock.
+// The caller must pass the original size to cc_slab_free
+// since objects do not have a header. Sizes larger than
+// the largest size class fall back to MALLOC/FREE.
+//
+// Slabs are allocated with MALLOC so they are included in
+// the MEMCOUNT/MEMSIZE totals. Once all objects in a size
+// class have been freed the slabs are returned except for
+// CC_SLAB_RETAIN slabs which are kept so that alloc/free
+// cycles do not allocate a new slab each time. The retained
+// slabs are returned by cc_slab_flush. The tag variants
+// additionally account the objects to a memory tag (see
+// cc_memtag_stats) since the slabs themselves are untagged.
+
+//
+// The slabs are bypassed by MEMORY_DEBUG/MEMORY_PROFILE so
+// that each object is tracked individually by its caller.
+
+#if defined(MEMORY_DEBUG) || defined(MEMORY_PROFILE)
+	#define CC_SLAB_BYPASS
+#endif
+
+#ifdef CC_SLAB_BYPASS
+	#define cc_slab_alloc(size)             (MALLOC(size))
+	#define cc_slab_calloc(size)            (CALLOC(1, size))
+	#define cc_slab_free(ptr, size)         (FREE(ptr))
+	#define cc_slab_allocTag(tag, size)     (MALLOC_TAG(tag, size))
+	#define cc_slab_callocTag(tag, size)    (CALLOC_TAG(tag, 1, size))
+	#define cc_slab_freeTag(tag, ptr, size) (FREE(ptr))
+#else
+void* cc_slab_alloc(size_t size);
+void* cc_slab_calloc(size_t size);
+void  cc_slab_free(void* ptr, size_t size);
+void* cc_slab_allocTag(int tag, size_t size);
+void* cc_slab_callocTag(int tag, size_t size);
+void  cc_slab_freeTag(int tag, void* ptr, size_t size);
+#endif
+void  cc_slab_flush(void);
+
+#endif
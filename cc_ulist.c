@@ -0,0 +1,567 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "cc"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_ulist.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static cc_ulistNode_t*
+cc_ulistNode_new(cc_ulist_t* self, cc_ulistNode_t* prev,
+                 cc_ulistNode_t* next)
+{
+	// prev and next may be NULL
+	ASSERT(self);
+
+	cc_ulistNode_t* node;
+	node = (cc_ulistNode_t*)
+	       MALLOC_TAG(CC_MEMTAG_LIST, sizeof(cc_ulistNode_t));
+	if(node == NULL)
+	{
+		LOGE("MALLOC_TAG failed");
+		return NULL;
+	}
+
+	node->next  = next;
+	node->prev  = prev;
+	node->count = 0;
+
+	if(prev)
+	{
+		prev->next = node;
+	}
+	else
+	{
+		self->head = node;
+	}
+
+	if(next)
+	{
+		next->prev = node;
+	}
+	else
+	{
+		self->tail = node;
+	}
+
+	++self->nodes;
+
+	return node;
+}
+
+static void
+cc_ulistNode_delete(cc_ulist_t* self, cc_ulistNode_t** _node)
+{
+	ASSERT(self);
+	ASSERT(_node);
+
+	cc_ulistNode_t* node = *_node;
+	if(node)
+	{
+		if(node->prev)
+		{
+			node->prev->next = node->next;
+		}
+		else
+		{
+			self->head = node->next;
+		}
+
+		if(node->next)
+		{
+			node->next->prev = node->prev;
+		}
+		else
+		{
+			self->tail = node->prev;
+		}
+
+		--self->nodes;
+
+		FREE(node);
+		*_node = NULL;
+	}
+}
+
+// insert data at idx in node which may require the node to
+// be split and returns the node/idx of the inserted data
+static int
+cc_ulist_insertNode(cc_ulist_t* self, cc_ulistNode_t* node,
+                    int idx, cc_ulistIter_t* iter,
+                    const void* data)
+{
+	ASSERT(self);
+	ASSERT(node);
+	ASSERT((idx >= 0) && (idx <= node->count));
+	ASSERT(data);
+
+	if(node->count == CC_ULIST_NODE_SIZE)
+	{
+		// prefer to spill into the next node when
+		// appending to the end of a full node
+		cc_ulistNode_t* next = node->next;
+		if((idx == CC_ULIST_NODE_SIZE) &&
+		   ((next == NULL) ||
+		    (next->count == CC_ULIST_NODE_SIZE)))
+		{
+			next = cc_ulistNode_new(self, node, next);
+			if(next == NULL)
+			{
+				return 0;
+			}
+			node = next;
+			idx  = 0;
+		}
+		else if(idx == CC_ULIST_NODE_SIZE)
+		{
+			node = next;
+			idx  = 0;
+		}
+		else
+		{
+			// split the upper half into a new node
+			next = cc_ulistNode_new(self, node, next);
+			if(next == NULL)
+			{
+				return 0;
+			}
+
+			int half = CC_ULIST_NODE_SIZE/2;
+			memcpy((void*) next->data,
+			       (const void*) &node->data[half],
+			       (CC_ULIST_NODE_SIZE - half)*
+			       sizeof(const void*));
+			next->count = CC_ULIST_NODE_SIZE - half;
+			node->count = half;
+
+			if(idx > half)
+			{
+				node = next;
+				idx -= half;
+			}
+		}
+	}
+
+	if(idx < node->count)
+	{
+		memmove((void*) &node->data[idx + 1],
+		        (const void*) &node->data[idx],
+		        (node->count - idx)*sizeof(const void*));
+	}
+	node->data[idx] = data;
+	++node->count;
+	++self->size;
+
+	if(iter)
+	{
+		iter->node = node;
+		iter->idx  = idx;
+	}
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_ulist_t* cc_ulist_new(void)
+{
+	cc_ulist_t* self;
+	self = (cc_ulist_t*)
+	       CALLOC_TAG(CC_MEMTAG_LIST, 1, sizeof(cc_ulist_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC_TAG failed");
+		return NULL;
+	}
+
+	return self;
+}
+
+void cc_ulist_delete(cc_ulist_t** _self)
+{
+	ASSERT(_self);
+
+	cc_ulist_t* self = *_self;
+	if(self)
+	{
+		if(self->size > 0)
+		{
+			LOGE("memory leak detected: size=%i", self->size);
+		}
+
+		cc_ulist_discard(self);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+void cc_ulist_discard(cc_ulist_t* self)
+{
+	ASSERT(self);
+
+	while(self->head)
+	{
+		cc_ulistNode_t* node = self->head;
+		cc_ulistNode_delete(self, &node);
+	}
+	self->size = 0;
+}
+
+int cc_ulist_size(const cc_ulist_t* self)
+{
+	ASSERT(self);
+
+	return self->size;
+}
+
+size_t cc_ulist_sizeof(const cc_ulist_t* self)
+{
+	ASSERT(self);
+
+	return sizeof(cc_ulist_t) +
+	       self->nodes*sizeof(cc_ulistNode_t);
+}
+
+const void* cc_ulist_peekHead(const cc_ulist_t* self)
+{
+	ASSERT(self);
+
+	if(self->head == NULL)
+	{
+		return NULL;
+	}
+
+	return self->head->data[0];
+}
+
+const void* cc_ulist_peekTail(const cc_ulist_t* self)
+{
+	ASSERT(self);
+
+	if(self->tail == NULL)
+	{
+		return NULL;
+	}
+
+	return self->tail->data[self->tail->count - 1];
+}
+
+const void* cc_ulist_peekIter(const cc_ulistIter_t* iter)
+{
+	ASSERT(iter);
+	ASSERT(iter->node);
+
+	return iter->node->data[iter->idx];
+}
+
+cc_ulistIter_t*
+cc_ulist_head(const cc_ulist_t* self, cc_ulistIter_t* iter)
+{
+	ASSERT(self);
+	ASSERT(iter);
+
+	if(self->head == NULL)
+	{
+		return NULL;
+	}
+
+	iter->node = self->head;
+	iter->idx  = 0;
+
+	return iter;
+}
+
+cc_ulistIter_t*
+cc_ulist_tail(const cc_ulist_t* self, cc_ulistIter_t* iter)
+{
+	ASSERT(self);
+	ASSERT(iter);
+
+	if(self->tail == NULL)
+	{
+		return NULL;
+	}
+
+	iter->node = self->tail;
+	iter->idx  = self->tail->count - 1;
+
+	return iter;
+}
+
+cc_ulistIter_t* cc_ulist_next(cc_ulistIter_t* iter)
+{
+	ASSERT(iter);
+	ASSERT(iter->node);
+
+	++iter->idx;
+	if(iter->idx < iter->node->count)
+	{
+		return iter;
+	}
+
+	iter->node = iter->node->next;
+	iter->idx  = 0;
+	if(iter->node == NULL)
+	{
+		return NULL;
+	}
+
+	return iter;
+}
+
+cc_ulistIter_t* cc_ulist_prev(cc_ulistIter_t* iter)
+{
+	ASSERT(iter);
+	ASSERT(iter->node);
+
+	--iter->idx;
+	if(iter->idx >= 0)
+	{
+		return iter;
+	}
+
+	iter->node = iter->node->prev;
+	if(iter->node == NULL)
+	{
+		iter->idx = 0;
+		return NULL;
+	}
+	iter->idx = iter->node->count - 1;
+
+	return iter;
+}
+
+cc_ulistIter_t*
+cc_ulist_get(const cc_ulist_t* self, int idx,
+             cc_ulistIter_t* iter)
+{
+	ASSERT(self);
+	ASSERT(iter);
+
+	if((idx < 0) || (idx >= self->size))
+	{
+		return NULL;
+	}
+
+	// skip whole nodes
+	cc_ulistNode_t* node = self->head;
+	while(idx >= node->count)
+	{
+		idx -= node->count;
+		node = node->next;
+	}
+
+	iter->node = node;
+	iter->idx  = idx;
+
+	return iter;
+}
+
+cc_ulistIter_t*
+cc_ulist_find(const cc_ulist_t* self, const void* data,
+              cc_listcmp_fn compare, cc_ulistIter_t* iter)
+{
+	ASSERT(self);
+	ASSERT(data);
+	ASSERT(compare);
+	ASSERT(iter);
+
+	cc_ulistNode_t* node = self->head;
+	while(node)
+	{
+		int i;
+		for(i = 0; i < node->count; ++i)
+		{
+			if((*compare)(node->data[i], data) == 0)
+			{
+				iter->node = node;
+				iter->idx  = i;
+				return iter;
+			}
+		}
+		node = node->next;
+	}
+
+	return NULL;
+}
+
+int cc_ulist_insert(cc_ulist_t* self, cc_ulistIter_t* iter,
+                    const void* data)
+{
+	// iter may be NULL to insert at head
+	// otherwise data is inserted before iter and iter
+	// is updated to reference the inserted data
+	ASSERT(self);
+	ASSERT(data);
+
+	if(iter)
+	{
+		return cc_ulist_insertNode(self, iter->node,
+		                           iter->idx, iter, data);
+	}
+	else if(self->head == NULL)
+	{
+		if(cc_ulistNode_new(self, NULL, NULL) == NULL)
+		{
+			return 0;
+		}
+	}
+
+	return cc_ulist_insertNode(self, self->head, 0, NULL,
+	                           data);
+}
+
+int cc_ulist_append(cc_ulist_t* self, cc_ulistIter_t* iter,
+                    const void* data)
+{
+	// iter may be NULL to append at tail
+	// otherwise data is appended after iter and iter
+	// is updated to reference the appended data
+	ASSERT(self);
+	ASSERT(data);
+
+	if(iter)
+	{
+		return cc_ulist_insertNode(self, iter->node,
+		                           iter->idx + 1, iter, data);
+	}
+	else if(self->tail == NULL)
+	{
+		if(cc_ulistNode_new(self, NULL, NULL) == NULL)
+		{
+			return 0;
+		}
+	}
+
+	return cc_ulist_insertNode(self, self->tail,
+	                           self->tail->count, NULL, data);
+}
+
+const void* cc_ulist_replace(cc_ulistIter_t* iter,
+                             const void* data)
+{
+	ASSERT(iter);
+	ASSERT(iter->node);
+	ASSERT(data);
+
+	const void* tmp = iter->node->data[iter->idx];
+	iter->node->data[iter->idx] = data;
+	return tmp;
+}
+
+const void*
+cc_ulist_remove(cc_ulist_t* self, cc_ulistIter_t** _iter)
+{
+	ASSERT(self);
+	ASSERT(_iter);
+	ASSERT(*_iter);
+
+	cc_ulistIter_t* iter = *_iter;
+	cc_ulistNode_t* node = iter->node;
+	int             idx  = iter->idx;
+	ASSERT(node);
+
+	const void* data = node->data[idx];
+	--node->count;
+	--self->size;
+	if(idx < node->count)
+	{
+		memmove((void*) &node->data[idx],
+		        (const void*) &node->data[idx + 1],
+		        (node->count - idx)*sizeof(const void*));
+	}
+
+	// merge the next node when both are at most half full
+	cc_ulistNode_t* next = node->next;
+	if(next && (node->count > 0) &&
+	   (node->count + next->count <= CC_ULIST_NODE_SIZE/2))
+	{
+		memcpy((void*) &node->data[node->count],
+		       (const void*) next->data,
+		       next->count*sizeof(const void*));
+		node->count += next->count;
+		cc_ulistNode_delete(self, &next);
+	}
+
+	// update the iter to reference the next element
+	if(idx < node->count)
+	{
+		iter->idx = idx;
+	}
+	else
+	{
+		iter->node = node->next;
+		iter->idx  = 0;
+	}
+
+	if(node->count == 0)
+	{
+		cc_ulistNode_delete(self, &node);
+	}
+
+	if(iter->node == NULL)
+	{
+		*_iter = NULL;
+	}
+
+	return data;
+}
+
+const void* cc_ulist_popHead(cc_ulist_t* self)
+{
+	ASSERT(self);
+
+	cc_ulistIter_t  iterator;
+	cc_ulistIter_t* iter;
+	iter = cc_ulist_head(self, &iterator);
+	if(iter == NULL)
+	{
+		return NULL;
+	}
+
+	return cc_ulist_remove(self, &iter);
+}
+
+const void* cc_ulist_popTail(cc_ulist_t* self)
+{
+	ASSERT(self);
+
+	cc_ulistIter_t  iterator;
+	cc_ulistIter_t* iter;
+	iter = cc_ulist_tail(self, &iterator);
+	if(iter == NULL)
+	{
+		return NULL;
+	}
+
+	return cc_ulist_remove(self, &iter);
+}
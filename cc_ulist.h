@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_ulist_H
+#define cc_ulist_H
+
+#include <stddef.h>
+
+#include "cc_list.h"
+
+// The unrolled list stores up to CC_ULIST_NODE_SIZE element
+// references per node to reduce the per-element overhead
+// and the number of cache misses during sequential scans.
+// Iterators are cursors owned by the caller which are
+// invalidated by any insert or remove other than through
+// the cursor passed to the operation. The elements are
+// owned by the caller.
+
+// node size is 128 bytes on 64-bit platforms
+#define CC_ULIST_NODE_SIZE 14
+
+typedef struct cc_ulistNode_s
+{
+	struct cc_ulistNode_s* next;
+	struct cc_ulistNode_s* prev;
+	int                    count;
+	const void*            data[CC_ULIST_NODE_SIZE];
+} cc_ulistNode_t;
+
+typedef struct
+{
+	cc_ulistNode_t* node;
+	int             idx;
+} cc_ulistIter_t;
+
+typedef struct
+{
+	int             size;
+	int             nodes;
+	cc_ulistNode_t* head;
+	cc_ulistNode_t* tail;
+} cc_ulist_t;
+
+cc_ulist_t*     cc_ulist_new(void);
+void            cc_ulist_delete(cc_ulist_t** _self);
+void            cc_ulist_discard(cc_ulist_t* self);
+int             cc_ulist_size(const cc_ulist_t* self);
+size_t          cc_ulist_sizeof(const cc_ulist_t* self);
+const void*     cc_ulist_peekHead(const cc_ulist_t* self);
+const void*     cc_ulist_peekTail(const cc_ulist_t* self);
+const void*     cc_ulist_peekIter(const cc_ulistIter_t* iter);
+cc_ulistIter_t* cc_ulist_head(const cc_ulist_t* self,
+                              cc_ulistIter_t* iter);
+cc_ulistIter_t* cc_ulist_tail(const cc_ulist_t* self,
+                              cc_ulistIter_t* iter);
+cc_ulistIter_t* cc_ulist_next(cc_ulistIter_t* iter);
+cc_ulistIter_t* cc_ulist_prev(cc_ulistIter_t* iter);
+cc_ulistIter_t* cc_ulist_get(const cc_ulist_t* self, int idx,
+                             cc_ulistIter_t* iter);
+cc_ulistIter_t* cc_ulist_find(const cc_ulist_t* self,
+                              const void* data,
+                              cc_listcmp_fn compare,
+                              cc_ulistIter_t* iter);
+int             cc_ulist_insert(cc_ulist_t* self,
+                                cc_ulistIter_t* iter,
+                                const void* data);
+int             cc_ulist_append(cc_ulist_t* self,
+                                cc_ulistIter_t* iter,
+                                const void* data);
+const void*     cc_ulist_replace(cc_ulistIter_t* iter,
+                                 const void* data);
+const void*     cc_ulist_remove(cc_ulist_t* self,
+                                cc_ulistIter_t** _iter);
+const void*     cc_ulist_popHead(cc_ulist_t* self);
+const void*     cc_ulist_popTail(cc_ulist_t* self);
+
+#endif
@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "cc"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_vector.h"
+
+#define CC_VECTOR_CAPACITY 16
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int cc_vector_resize(cc_vector_t* self, int capacity)
+{
+	ASSERT(self);
+	ASSERT(capacity >= self->size);
+
+	if(capacity == self->capacity)
+	{
+		return 1;
+	}
+	else if(capacity == 0)
+	{
+		FREE(self->data);
+		self->data     = NULL;
+		self->capacity = 0;
+		return 1;
+	}
+
+	// REALLOC preserves the tag of the initial array
+	const void** data;
+	size_t       size = capacity*sizeof(const void*);
+	if(self->data == NULL)
+	{
+		data = (const void**)
+		       MALLOC_TAG(CC_MEMTAG_VECTOR, size);
+	}
+	else
+	{
+		data = (const void**) REALLOC(self->data, size);
+	}
+
+	if(data == NULL)
+	{
+		LOGE("REALLOC failed");
+		return 0;
+	}
+
+	self->data     = data;
+	self->capacity = capacity;
+
+	return 1;
+}
+
+static int cc_vector_grow(cc_vector_t* self, int count)
+{
+	ASSERT(self);
+
+	if(self->size + count <= self->capacity)
+	{
+		return 1;
+	}
+
+	int capacity = self->capacity ? self->capacity :
+	                                 CC_VECTOR_CAPACITY;
+	while(capacity < self->size + count)
+	{
+		capacity *= 2;
+	}
+
+	return cc_vector_resize(self, capacity);
+}
+
+static void
+cc_vector_merge(const void** src, const void** dst,
+                int a, int m, int b, cc_listcmp_fn compare)
+{
+	ASSERT(src);
+	ASSERT(dst);
+	ASSERT(compare);
+
+	// merge src[a,m) and src[m,b) to dst[a,b) where ties
+	// are taken from the first run so the merge is stable
+	int i = a;
+	int j = m;
+	int k = a;
+	while((i < m) && (j < b))
+	{
+		if((*compare)(src[j], src[i]) < 0)
+		{
+			dst[k++] = src[j++];
+		}
+		else
+		{
+			dst[k++] = src[i++];
+		}
+	}
+
+	while(i < m)
+	{
+		dst[k++] = src[i++];
+	}
+
+	while(j < b)
+	{
+		dst[k++] = src[j++];
+	}
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_vector_t* cc_vector_new(void)
+{
+	cc_vector_t* self;
+	self = (cc_vector_t*)
+	       CALLOC_TAG(CC_MEMTAG_VECTOR, 1, sizeof(cc_vector_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC_TAG failed");
+		return NULL;
+	}
+
+	return self;
+}
+
+void cc_vector_delete(cc_vector_t** _self)
+{
+	ASSERT(_self);
+
+	cc_vector_t* self = *_self;
+	if(self)
+	{
+		if(self->size > 0)
+		{
+			LOGE("memory leak detected: size=%i", self->size);
+		}
+
+		FREE(self->data);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+void cc_vector_discard(cc_vector_t* self)
+{
+	ASSERT(self);
+
+	// discard all elements without freeing the array
+	self->size = 0;
+}
+
+int cc_vector_size(const cc_vector_t* self)
+{
+	ASSERT(self);
+
+	return self->size;
+}
+
+size_t cc_vector_sizeof(const cc_vector_t* self)
+{
+	ASSERT(self);
+
+	return sizeof(cc_vector_t) +
+	       self->capacity*sizeof(const void*);
+}
+
+int cc_vector_reserve(cc_vector_t* self, int capacity)
+{
+	ASSERT(self);
+
+	if(capacity <= self->capacity)
+	{
+		return 1;
+	}
+
+	return cc_vector_resize(self, capacity);
+}
+
+void cc_vector_shrink(cc_vector_t* self)
+{
+	ASSERT(self);
+
+	// silently fail
+	cc_vector_resize(self, self->size);
+}
+
+const void* cc_vector_get(const cc_vector_t* self, int idx)
+{
+	ASSERT(self);
+	ASSERT((idx >= 0) && (idx < self->size));
+
+	return self->data[idx];
+}
+
+const void* cc_vector_peekHead(const cc_vector_t* self)
+{
+	ASSERT(self);
+
+	if(self->size == 0)
+	{
+		return NULL;
+	}
+
+	return self->data[0];
+}
+
+const void* cc_vector_peekTail(const cc_vector_t* self)
+{
+	ASSERT(self);
+
+	if(self->size == 0)
+	{
+		return NULL;
+	}
+
+	return self->data[self->size - 1];
+}
+
+const void*
+cc_vector_replace(cc_vector_t* self, int idx,
+                  const void* data)
+{
+	ASSERT(self);
+	ASSERT((idx >= 0) && (idx < self->size));
+	ASSERT(data);
+
+	const void* tmp = self->data[idx];
+	self->data[idx] = data;
+	return tmp;
+}
+
+int cc_vector_append(cc_vector_t* self, const void* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	if(cc_vector_grow(self, 1) == 0)
+	{
+		return 0;
+	}
+
+	self->data[self->size] = data;
+	++self->size;
+
+	return 1;
+}
+
+int cc_vector_appendArray(cc_vector_t* self, int count,
+                          const void** data)
+{
+	ASSERT(self);
+	ASSERT(count >= 0);
+	ASSERT(data || (count == 0));
+
+	if(count == 0)
+	{
+		return 1;
+	}
+
+	if(cc_vector_grow(self, count) == 0)
+	{
+		return 0;
+	}
+
+	memcpy((void*) &self->data[self->size],
+	       (const void*) data, count*sizeof(const void*));
+	self->size += count;
+
+	return 1;
+}
+
+int cc_vector_insert(cc_vector_t* self, int idx,
+                     const void* data)
+{
+	ASSERT(self);
+	ASSERT((idx >= 0) && (idx <= self->size));
+	ASSERT(data);
+
+	if(cc_vector_grow(self, 1) == 0)
+	{
+		return 0;
+	}
+
+	memmove((void*) &self->data[idx + 1],
+	        (const void*) &self->data[idx],
+	        (self->size - idx)*sizeof(const void*));
+	self->data[idx] = data;
+	++self->size;
+
+	return 1;
+}
+
+const void* cc_vector_remove(cc_vector_t* self, int idx)
+{
+	ASSERT(self);
+	ASSERT((idx >= 0) && (idx < self->size));
+
+	const void* data = self->data[idx];
+	memmove((void*) &self->data[idx],
+	        (const void*) &self->data[idx + 1],
+	        (self->size - idx - 1)*sizeof(const void*));
+	--self->size;
+
+	return data;
+}
+
+const void* cc_vector_removeSwap(cc_vector_t* self, int idx)
+{
+	ASSERT(self);
+	ASSERT((idx >= 0) && (idx < self->size));
+
+	// replace the element with the tail element
+	const void* data = self->data[idx];
+	--self->size;
+	self->data[idx] = self->data[self->size];
+
+	return data;
+}
+
+const void* cc_vector_pop(cc_vector_t* self)
+{
+	ASSERT(self);
+
+	if(self->size == 0)
+	{
+		return NULL;
+	}
+
+	--self->size;
+	return self->data[self->size];
+}
+
+int cc_vector_sort(cc_vector_t* self, cc_listcmp_fn compare)
+{
+	ASSERT(self);
+	ASSERT(compare);
+
+	int n = self->size;
+	if(n < 2)
+	{
+		return 1;
+	}
+
+	const void** tmp;
+	tmp = (const void**) MALLOC(n*sizeof(const void*));
+	if(tmp == NULL)
+	{
+		LOGE("MALLOC failed");
+		return 0;
+	}
+
+	// bottom-up merge sort which alternates between the
+	// data and tmp arrays
+	const void** src = self->data;
+	const void** dst = tmp;
+	int width;
+	for(width = 1; width < n; width *= 2)
+	{
+		int a;
+		for(a = 0; a < n; a += 2*width)
+		{
+			int m = (a + width < n) ? a + width : n;
+			int b = (a + 2*width < n) ? a + 2*width : n;
+			cc_vector_merge(src, dst, a, m, b, compare);
+		}
+
+		const void** swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if(src != self->data)
+	{
+		memcpy((void*) self->data, (const void*) src,
+		       n*sizeof(const void*));
+	}
+
+	FREE(tmp);
+
+	return 1;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_vector_H
+#define cc_vector_H
+
+#include <stddef.h>
+
+#include "cc_list.h"
+
+// The vector is a contiguous array of element references
+// with amortized growth. Indexing is O(1) and removal is
+// O(n) except for cc_vector_removeSwap/cc_vector_pop which
+// are O(1). The elements are owned by the caller.
+
+typedef struct
+{
+	int          size;
+	int          capacity;
+	const void** data;
+} cc_vector_t;
+
+cc_vector_t* cc_vector_new(void);
+void         cc_vector_delete(cc_vector_t** _self);
+void         cc_vector_discard(cc_vector_t* self);
+int          cc_vector_size(const cc_vector_t* self);
+size_t       cc_vector_sizeof(const cc_vector_t* self);
+int          cc_vector_reserve(cc_vector_t* self,
+                               int capacity);
+void         cc_vector_shrink(cc_vector_t* self);
+const void*  cc_vector_get(const cc_vector_t* self, int idx);
+const void*  cc_vector_peekHead(const cc_vector_t* self);
+const void*  cc_vector_peekTail(const cc_vector_t* self);
+const void*  cc_vector_replace(cc_vector_t* self, int idx,
+                               const void* data);
+int          cc_vector_append(cc_vector_t* self,
+                              const void* data);
+int          cc_vector_appendArray(cc_vector_t* self,
+                                   int count,
+                                   const void** data);
+int          cc_vector_insert(cc_vector_t* self, int idx,
+                              const void* data);
+const void*  cc_vector_remove(cc_vector_t* self, int idx);
+const void*  cc_vector_removeSwap(cc_vector_t* self, int idx);
+const void*  cc_vector_pop(cc_vector_t* self);
+int          cc_vector_sort(cc_vector_t* self,
+                            cc_listcmp_fn compare);
+
+#endif
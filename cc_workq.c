@@ -28,6 +28,7 @@
 #define LOG_TAG "cc"
 #include "cc_log.h"
 #include "cc_memory.h"
+#include "cc_slab.h"
 #include "cc_workq.h"
 
 /***********************************************************
@@ -48,10 +49,12 @@ cc_workqNode_new(void* task, int purge_id, int priority)
 	ASSERT((purge_id == 0) || (purge_id == 1));
 
 	cc_workqNode_t* self;
-	self = (cc_workqNode_t*) MALLOC(sizeof(cc_workqNode_t));
+	self = (cc_workqNode_t*)
+	       cc_slab_allocTag(CC_MEMTAG_WORKQ,
+	                        sizeof(cc_workqNode_t));
 	if(!self)
 	{
-		LOGE("MALLOC failed");
+		LOGE("cc_slab_allocTag failed");
 		return NULL;
 	}
 
@@ -70,26 +73,25 @@ static void cc_workqNode_delete(cc_workqNode_t** _self)
 	cc_workqNode_t* self = *_self;
 	if(self)
 	{
-		FREE(self);
+		cc_slab_freeTag(CC_MEMTAG_WORKQ, self,
+		                sizeof(cc_workqNode_t));
 		*_self = NULL;
 	}
 }
 
 static void
 cc_workq_removeLocked(cc_workq_t* self, int finish,
-                      cc_list_t* queue,
-                      cc_listIter_t** _iter)
+                      cc_ilist_t* queue,
+                      cc_workqNode_t* node)
 {
 	ASSERT(self);
 	ASSERT(queue);
-	ASSERT(_iter);
+	ASSERT(node);
 
-	cc_workqNode_t* node;
-	cc_mapIter_t*   miter;
-	node  = (cc_workqNode_t*)
-	        cc_list_remove(queue, _iter);
-	miter = cc_map_findp(self->map_task, 0, node->task);
-	cc_map_remove(self->map_task, &miter);
+	cc_ptrmapIter_t* miter;
+	cc_ilist_remove(queue, &node->link);
+	miter = cc_ptrmap_findp(self->map_task, node->task);
+	cc_ptrmap_remove(self->map_task, &miter);
 
 	if(finish)
 	{
@@ -119,7 +121,7 @@ static void* cc_workq_thread(void* arg)
 	while(1)
 	{
 		// pending for an event
-		while((cc_list_size(self->queue_pending) == 0) &&
+		while((cc_ilist_size(&self->queue_pending) == 0) &&
 		      (self->state == CC_WORKQ_STATE_RUNNING))
 		{
 			pthread_cond_wait(&self->cond_pending,
@@ -134,12 +136,11 @@ static void* cc_workq_thread(void* arg)
 		}
 
 		// get the task
-		cc_listIter_t*  iter;
 		cc_workqNode_t* node;
-		iter = cc_list_head(self->queue_pending);
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
-		cc_list_swapn(self->queue_pending,
-		              self->queue_active, iter, NULL);
+		node = CC_ILIST_ENTRY(cc_ilist_head(&self->queue_pending),
+		                      cc_workqNode_t, link);
+		cc_ilist_swapn(&self->queue_pending,
+		               &self->queue_active, &node->link, NULL);
 		node->status = CC_WORKQ_STATUS_ACTIVE;
 
 		pthread_mutex_unlock(&self->mutex);
@@ -153,8 +154,8 @@ static void* cc_workq_thread(void* arg)
 		// put the task on the complete queue
 		node->status = ret ? CC_WORKQ_STATUS_COMPLETE :
 		                     CC_WORKQ_STATUS_FAILURE;
-		cc_list_swapn(self->queue_active,
-		              self->queue_complete, iter, NULL);
+		cc_ilist_swapn(&self->queue_active,
+		               &self->queue_complete, &node->link, NULL);
 		pthread_cond_broadcast(&self->cond_complete);
 	}
 }
@@ -162,12 +163,15 @@ static void cc_workq_flushLocked(cc_workq_t* self)
 {
 	ASSERT(self);
 
-	cc_listIter_t* iter;
-	iter = cc_list_head(self->queue_complete);
-	while(iter)
+	cc_ilistLink_t* link;
+	link = cc_ilist_head(&self->queue_complete);
+	while(link)
 	{
-		cc_workq_removeLocked(self, 1, self->queue_complete,
-		                      &iter);
+		cc_workqNode_t* node;
+		node = CC_ILIST_ENTRY(link, cc_workqNode_t, link);
+		link = cc_ilist_next(link);
+		cc_workq_removeLocked(self, 1, &self->queue_complete,
+		                      node);
 	}
 }
 
@@ -186,10 +190,11 @@ cc_workq_new(void* owner, int thread_count,
 	ASSERT(finish_fn);
 
 	cc_workq_t* self;
-	self = (cc_workq_t*) MALLOC(sizeof(cc_workq_t));
+	self = (cc_workq_t*)
+	       MALLOC_TAG(CC_MEMTAG_WORKQ, sizeof(cc_workq_t));
 	if(!self)
 	{
-		LOGE("MALLOC failed");
+		LOGE("MALLOC_TAG failed");
 		return NULL;
 	}
 
@@ -221,29 +226,15 @@ cc_workq_new(void* owner, int thread_count,
 		goto fail_cond_complete;
 	}
 
-	self->map_task = cc_map_new();
+	self->map_task = cc_ptrmap_new();
 	if(self->map_task == NULL)
 	{
 		goto fail_map_task;
 	}
 
-	self->queue_pending = cc_list_new();
-	if(self->queue_pending == NULL)
-	{
-		goto fail_queue_pending;
-	}
-
-	self->queue_complete = cc_list_new();
-	if(self->queue_complete == NULL)
-	{
-		goto fail_queue_complete;
-	}
-
-	self->queue_active = cc_list_new();
-	if(self->queue_active == NULL)
-	{
-		goto fail_queue_active;
-	}
+	cc_ilist_init(&self->queue_pending);
+	cc_ilist_init(&self->queue_complete);
+	cc_ilist_init(&self->queue_active);
 
 	// alloc threads
 	int sz = thread_count*sizeof(pthread_t);
@@ -284,13 +275,7 @@ cc_workq_new(void* owner, int thread_count,
 		}
 		FREE(self->threads);
 	fail_threads:
-		cc_list_delete(&self->queue_active);
-	fail_queue_active:
-		cc_list_delete(&self->queue_complete);
-	fail_queue_complete:
-		cc_list_delete(&self->queue_pending);
-	fail_queue_pending:
-		cc_map_delete(&self->map_task);
+		cc_ptrmap_delete(&self->map_task);
 	fail_map_task:
 		pthread_cond_destroy(&self->cond_complete);
 	fail_cond_complete:
@@ -328,10 +313,7 @@ void cc_workq_delete(cc_workq_t** _self)
 		// stopped
 		self->purge_id = CC_WORKQ_PURGE;
 		cc_workq_purge(self);
-		cc_list_delete(&self->queue_active);
-		cc_list_delete(&self->queue_complete);
-		cc_list_delete(&self->queue_pending);
-		cc_map_delete(&self->map_task);
+		cc_ptrmap_delete(&self->map_task);
 
 		// destroy the thread state
 		pthread_cond_destroy(&self->cond_complete);
@@ -359,7 +341,7 @@ void cc_workq_reset(cc_workq_t* self, int blocking)
 	{
 		// blocking wait for the active queue
 		pthread_mutex_lock(&self->mutex);
-		while(cc_list_size(self->queue_active) > 0)
+		while(cc_ilist_size(&self->queue_active) > 0)
 		{
 			// must wait for active task to complete
 			pthread_cond_wait(&self->cond_complete,
@@ -382,51 +364,45 @@ void cc_workq_purge(cc_workq_t* self)
 	pthread_mutex_lock(&self->mutex);
 
 	// purge the pending queue
-	cc_listIter_t* iter;
-	iter = cc_list_head(self->queue_pending);
-	while(iter)
+	cc_ilistLink_t* link;
+	link = cc_ilist_head(&self->queue_pending);
+	while(link)
 	{
 		cc_workqNode_t* node;
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
+		node = CC_ILIST_ENTRY(link, cc_workqNode_t, link);
+		link = cc_ilist_next(link);
 		if(node->purge_id != self->purge_id)
 		{
-			cc_workq_removeLocked(self, 1, self->queue_pending,
-			                      &iter);
-		}
-		else
-		{
-			iter = cc_list_next(iter);
+			cc_workq_removeLocked(self, 1, &self->queue_pending,
+			                      node);
 		}
 	}
 
 	// purge the active queue (non-blocking)
-	iter = cc_list_head(self->queue_active);
-	while(iter)
+	link = cc_ilist_head(&self->queue_active);
+	while(link)
 	{
 		cc_workqNode_t* node;
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
+		node = CC_ILIST_ENTRY(link, cc_workqNode_t, link);
 		if(node->purge_id != self->purge_id)
 		{
 			node->purge_id = CC_WORKQ_PURGE;
 		}
-		iter = cc_list_next(iter);
+		link = cc_ilist_next(link);
 	}
 
 	// purge the complete queue
-	iter = cc_list_head(self->queue_complete);
-	while(iter)
+	link = cc_ilist_head(&self->queue_complete);
+	while(link)
 	{
 		cc_workqNode_t* node;
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
+		node = CC_ILIST_ENTRY(link, cc_workqNode_t, link);
+		link = cc_ilist_next(link);
 		if((node->purge_id != self->purge_id) ||
 		   (node->purge_id == CC_WORKQ_PURGE))
 		{
-			cc_workq_removeLocked(self, 1, self->queue_complete,
-			                      &iter);
-		}
-		else
-		{
-			iter = cc_list_next(iter);
+			cc_workq_removeLocked(self, 1, &self->queue_complete,
+			                      node);
 		}
 	}
 
@@ -456,14 +432,14 @@ void cc_workq_finish(cc_workq_t* self)
 
 	while(1)
 	{
-		if(cc_list_size(self->queue_complete))
+		if(cc_ilist_size(&self->queue_complete))
 		{
 			// flush any tasks which have completed
 			cc_workq_flushLocked(self);
 		}
 
-		if(cc_list_size(self->queue_pending) ||
-		   cc_list_size(self->queue_active))
+		if(cc_ilist_size(&self->queue_pending) ||
+		   cc_ilist_size(&self->queue_active))
 		{
 			// wait for pending/active tasks to complete
 			pthread_cond_wait(&self->cond_complete,
@@ -489,12 +465,11 @@ int cc_workq_run(cc_workq_t* self, void* task,
 	int status = CC_WORKQ_STATUS_ERROR;
 
 	// find the node containing the task or create a new one
-	cc_listIter_t*  iter;
-	cc_mapIter_t*   miter;
-	cc_workqNode_t* node;
-	cc_listIter_t*  pos;
-	cc_workqNode_t* tmp;
-	miter = cc_map_findp(self->map_task, 0, task);
+	cc_ptrmapIter_t* miter;
+	cc_workqNode_t*  node;
+	cc_ilistLink_t*  pos;
+	cc_workqNode_t*  tmp;
+	miter = cc_ptrmap_findp(self->map_task, task);
 	if(miter == NULL)
 	{
 		// create new node
@@ -506,42 +481,33 @@ int cc_workq_run(cc_workq_t* self, void* task,
 		}
 
 		// find the insert position
-		pos = cc_list_tail(self->queue_pending);
+		pos = cc_ilist_tail(&self->queue_pending);
 		while(pos)
 		{
-			tmp = (cc_workqNode_t*)
-			      cc_list_peekIter(pos);
+			tmp = CC_ILIST_ENTRY(pos, cc_workqNode_t, link);
 			if(tmp->priority >= node->priority)
 			{
 				break;
 			}
-			pos = cc_list_prev(pos);
+			pos = cc_ilist_prev(pos);
 		}
 
 		if(pos)
 		{
 			// append after pos
-			iter = cc_list_append(self->queue_pending, pos,
-			                      (const void*) node);
-			if(iter == NULL)
-			{
-				goto fail_queue;
-			}
+			cc_ilist_append(&self->queue_pending, pos,
+			                &node->link);
 		}
 		else
 		{
 			// insert at head of queue
 			// first item or highest priority
-			iter = cc_list_insert(self->queue_pending, NULL,
-			                      (const void*) node);
-			if(iter == NULL)
-			{
-				goto fail_queue;
-			}
+			cc_ilist_insert(&self->queue_pending, NULL,
+			                &node->link);
 		}
 
-		if(cc_map_addp(self->map_task, (const void*) iter,
-		               0, task) == NULL)
+		if(cc_ptrmap_addp(self->map_task, (const void*) node,
+		                  task) == NULL)
 		{
 			goto fail_map_add;
 		}
@@ -553,74 +519,69 @@ int cc_workq_run(cc_workq_t* self, void* task,
 	}
 	else
 	{
-		iter = (cc_listIter_t*)  cc_map_val(miter);
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
+		node = (cc_workqNode_t*) cc_ptrmap_val(miter);
 	}
 
 	if(node->status == CC_WORKQ_STATUS_ACTIVE)
 	{
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
 		node->purge_id = self->purge_id;
 		status = node->status;
 	}
 	else if(node->status == CC_WORKQ_STATUS_PENDING)
 	{
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
 		node->purge_id = self->purge_id;
 		if(priority > node->priority)
 		{
 			// move up
-			pos = cc_list_prev(iter);
+			pos = cc_ilist_prev(&node->link);
 			while(pos)
 			{
-				tmp = (cc_workqNode_t*)
-				      cc_list_peekIter(pos);
+				tmp = CC_ILIST_ENTRY(pos, cc_workqNode_t, link);
 				if(tmp->priority >= node->priority)
 				{
 					break;
 				}
-				pos = cc_list_prev(pos);
+				pos = cc_ilist_prev(pos);
 			}
 
 			if(pos)
 			{
 				// move after pos
-				cc_list_moven(self->queue_pending, iter,
-				              pos);
+				cc_ilist_moven(&self->queue_pending,
+				               &node->link, pos);
 			}
 			else
 			{
 				// move to head of list
-				cc_list_move(self->queue_pending, iter,
-				             NULL);
+				cc_ilist_move(&self->queue_pending,
+				              &node->link, NULL);
 			}
 		}
 		else if(priority < node->priority)
 		{
 			// move down
-			pos = cc_list_next(iter);
+			pos = cc_ilist_next(&node->link);
 			while(pos)
 			{
-				tmp = (cc_workqNode_t*)
-				      cc_list_peekIter(pos);
+				tmp = CC_ILIST_ENTRY(pos, cc_workqNode_t, link);
 				if(tmp->priority < node->priority)
 				{
 					break;
 				}
-				pos = cc_list_next(pos);
+				pos = cc_ilist_next(pos);
 			}
 
 			if(pos)
 			{
 				// move before pos
-				cc_list_move(self->queue_pending, iter,
-				             pos);
+				cc_ilist_move(&self->queue_pending,
+				              &node->link, pos);
 			}
 			else
 			{
 				// move to tail of list
-				cc_list_moven(self->queue_pending, iter,
-				              NULL);
+				cc_ilist_moven(&self->queue_pending,
+				               &node->link, NULL);
 			}
 		}
 		node->priority = priority;
@@ -628,10 +589,9 @@ int cc_workq_run(cc_workq_t* self, void* task,
 	}
 	else
 	{
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
 		status = node->status;
-		cc_workq_removeLocked(self, 0, self->queue_complete,
-		                      &iter);
+		cc_workq_removeLocked(self, 0, &self->queue_complete,
+		                      node);
 	}
 
 	pthread_mutex_unlock(&self->mutex);
@@ -641,8 +601,7 @@ int cc_workq_run(cc_workq_t* self, void* task,
 
 	// failure
 	fail_map_add:
-		cc_list_remove(self->queue_pending, &iter);
-	fail_queue:
+		cc_ilist_remove(&self->queue_pending, &node->link);
 		cc_workqNode_delete(&node);
 	fail_node:
 		pthread_mutex_unlock(&self->mutex);
@@ -660,18 +619,16 @@ int cc_workq_wait(cc_workq_t* self, void* task,
 	pthread_mutex_lock(&self->mutex);
 
 	// find task in map
-	cc_listIter_t* iter;
-	cc_mapIter_t*  miter;
-	miter = cc_map_findp(self->map_task, 0, task);
+	cc_ptrmapIter_t* miter;
+	miter = cc_ptrmap_findp(self->map_task, task);
 	if(miter == NULL)
 	{
 		pthread_mutex_unlock(&self->mutex);
 		return status;
 	}
-	iter = (cc_listIter_t*) cc_map_val(miter);
 
 	cc_workqNode_t* node;
-	node = (cc_workqNode_t*) cc_list_peekIter(iter);
+	node = (cc_workqNode_t*) cc_ptrmap_val(miter);
 	while((node->status == CC_WORKQ_STATUS_PENDING) ||
 	      (node->status == CC_WORKQ_STATUS_ACTIVE))
 	{
@@ -688,8 +645,8 @@ int cc_workq_wait(cc_workq_t* self, void* task,
 	status = node->status;
 
 	// cancel completed task
-	cc_workq_removeLocked(self, 0, self->queue_complete,
-	                      &iter);
+	cc_workq_removeLocked(self, 0, &self->queue_complete,
+	                      node);
 
 	pthread_mutex_unlock(&self->mutex);
 	return status;
@@ -706,18 +663,16 @@ int cc_workq_cancel(cc_workq_t* self, void* task,
 	pthread_mutex_lock(&self->mutex);
 
 	// find task in map
-	cc_listIter_t* iter;
-	cc_mapIter_t*  miter;
-	miter = cc_map_findp(self->map_task, 0, task);
+	cc_ptrmapIter_t* miter;
+	miter = cc_ptrmap_findp(self->map_task, task);
 	if(miter == NULL)
 	{
 		pthread_mutex_unlock(&self->mutex);
 		return status;
 	}
-	iter = (cc_listIter_t*) cc_map_val(miter);
 
 	cc_workqNode_t* node;
-	node = (cc_workqNode_t*) cc_list_peekIter(iter);
+	node = (cc_workqNode_t*) cc_ptrmap_val(miter);
 	while(node->status == CC_WORKQ_STATUS_ACTIVE)
 	{
 		if(blocking == 0)
@@ -734,14 +689,14 @@ int cc_workq_cancel(cc_workq_t* self, void* task,
 	if(status == CC_WORKQ_STATUS_PENDING)
 	{
 		// cancel pending task
-		cc_workq_removeLocked(self, 0, self->queue_pending,
-		                      &iter);
+		cc_workq_removeLocked(self, 0, &self->queue_pending,
+		                      node);
 	}
 	else
 	{
 		// cancel completed task
-		cc_workq_removeLocked(self, 0, self->queue_complete,
-		                      &iter);
+		cc_workq_removeLocked(self, 0, &self->queue_complete,
+		                      node);
 	}
 
 	pthread_mutex_unlock(&self->mutex);
@@ -757,14 +712,12 @@ int cc_workq_status(cc_workq_t* self, void* task)
 	pthread_mutex_lock(&self->mutex);
 
 	// find task in map
-	cc_listIter_t* iter;
-	cc_mapIter_t*  miter;
-	miter = cc_map_findp(self->map_task, 0, task);
+	cc_ptrmapIter_t* miter;
+	miter = cc_ptrmap_findp(self->map_task, task);
 	if(miter)
 	{
 		cc_workqNode_t* node;
-		iter = (cc_listIter_t*)  cc_map_val(miter);
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
+		node   = (cc_workqNode_t*) cc_ptrmap_val(miter);
 		status = node->status;
 	}
 
@@ -778,8 +731,8 @@ int cc_workq_pending(cc_workq_t* self)
 
 	int size;
 	pthread_mutex_lock(&self->mutex);
-	size = cc_list_size(self->queue_pending);
-	size += cc_list_size(self->queue_active);
+	size = cc_ilist_size(&self->queue_pending);
+	size += cc_ilist_size(&self->queue_active);
 	pthread_mutex_unlock(&self->mutex);
 	return size;
 }
@@ -26,8 +26,9 @@
 
 #include <pthread.h>
 
+#include "cc_ilist.h"
 #include "cc_list.h"
-#include "cc_map.h"
+#include "cc_ptrmap.h"
 
 // workq status
 #define CC_WORKQ_STATUS_ERROR    0
@@ -52,10 +53,11 @@ typedef void (*cc_workqFinish_fn)(void* owner,
 
 typedef struct
 {
-	int   status;
-	int   priority;
-	int   purge_id;
-	void* task;
+	cc_ilistLink_t link;
+	int            status;
+	int            priority;
+	int            purge_id;
+	void*          task;
 } cc_workqNode_t;
 
 typedef struct
@@ -65,13 +67,13 @@ typedef struct
 	void* owner;
 	int   purge_id;
 
-	// maps from task to listIter
-	cc_map_t* map_task;
+	// maps from task to node
+	cc_ptrmap_t* map_task;
 
-	// queues
-	cc_list_t* queue_pending;
-	cc_list_t* queue_complete;
-	cc_list_t* queue_active;
+	// queues of nodes
+	cc_ilist_t queue_pending;
+	cc_ilist_t queue_complete;
+	cc_ilist_t queue_active;
 
 	// callbacks
 	cc_workqRun_fn    run_fn;
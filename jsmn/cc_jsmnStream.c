@@ -21,6 +21,7 @@
  *
  */
 
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -462,3 +463,94 @@ int cc_jsmnStream_double(cc_jsmnStream_t* self, double val)
 
 	return cc_jsmnStream_val(self, CC_JSMN_TYPE_PRIMITIVE, str);
 }
+
+int cc_jsmnStream_uint64(cc_jsmnStream_t* self, uint64_t val)
+{
+	ASSERT(self);
+
+	char str[256];
+	snprintf(str, 256, "%" PRIu64, val);
+
+	return cc_jsmnStream_val(self, CC_JSMN_TYPE_PRIMITIVE, str);
+}
+
+int cc_jsmnStream_memstats(cc_jsmnStream_t* self,
+                           const cc_memstats_t* prev,
+                           const cc_memstats_t* stats)
+{
+	// prev is optional
+	ASSERT(self);
+	ASSERT(stats);
+
+	int ret = 1;
+	ret &= cc_jsmnStream_beginObject(self);
+	ret &= cc_jsmnStream_key(self, "%s", "ts");
+	ret &= cc_jsmnStream_double(self, stats->ts);
+	ret &= cc_jsmnStream_key(self, "%s", "count");
+	ret &= cc_jsmnStream_uint64(self, stats->count);
+	ret &= cc_jsmnStream_key(self, "%s", "size");
+	ret &= cc_jsmnStream_uint64(self, stats->size);
+	ret &= cc_jsmnStream_key(self, "%s", "peak");
+	ret &= cc_jsmnStream_uint64(self, stats->peak);
+	ret &= cc_jsmnStream_key(self, "%s", "alloc_count");
+	ret &= cc_jsmnStream_uint64(self, stats->alloc_count);
+	ret &= cc_jsmnStream_key(self, "%s", "free_count");
+	ret &= cc_jsmnStream_uint64(self, stats->free_count);
+
+	// rates are computed relative to the previous snapshot
+	double dt = prev ? (stats->ts - prev->ts) : 0.0;
+	if(dt > 0.0)
+	{
+		double alloc_rate;
+		double free_rate;
+		alloc_rate = (double) (stats->alloc_count -
+		                       prev->alloc_count)/dt;
+		free_rate  = (double) (stats->free_count -
+		                       prev->free_count)/dt;
+
+		ret &= cc_jsmnStream_key(self, "%s", "alloc_rate");
+		ret &= cc_jsmnStream_double(self, alloc_rate);
+		ret &= cc_jsmnStream_key(self, "%s", "free_rate");
+		ret &= cc_jsmnStream_double(self, free_rate);
+	}
+
+	ret &= cc_jsmnStream_key(self, "%s", "realloc");
+	ret &= cc_jsmnStream_beginObject(self);
+	ret &= cc_jsmnStream_key(self, "%s", "count");
+	ret &= cc_jsmnStream_uint64(self, stats->realloc_count);
+	ret &= cc_jsmnStream_key(self, "%s", "grow");
+	ret &= cc_jsmnStream_uint64(self, stats->realloc_grow);
+	ret &= cc_jsmnStream_key(self, "%s", "grow_size");
+	ret &= cc_jsmnStream_uint64(self, stats->realloc_grow_size);
+	ret &= cc_jsmnStream_key(self, "%s", "shrink");
+	ret &= cc_jsmnStream_uint64(self, stats->realloc_shrink);
+	ret &= cc_jsmnStream_key(self, "%s", "shrink_size");
+	ret &= cc_jsmnStream_uint64(self, stats->realloc_shrink_size);
+	ret &= cc_jsmnStream_end(self);
+
+	// histogram of non-empty buckets where lt is the
+	// exclusive upper bound of the allocation size
+	ret &= cc_jsmnStream_key(self, "%s", "histogram");
+	ret &= cc_jsmnStream_beginArray(self);
+
+	int i;
+	for(i = 0; i < CC_MEMSTATS_BUCKETS; ++i)
+	{
+		if(stats->histogram[i] == 0)
+		{
+			continue;
+		}
+
+		ret &= cc_jsmnStream_beginObject(self);
+		ret &= cc_jsmnStream_key(self, "%s", "lt");
+		ret &= cc_jsmnStream_uint64(self, ((uint64_t) 1) << i);
+		ret &= cc_jsmnStream_key(self, "%s", "count");
+		ret &= cc_jsmnStream_uint64(self, stats->histogram[i]);
+		ret &= cc_jsmnStream_end(self);
+	}
+
+	ret &= cc_jsmnStream_end(self);
+	ret &= cc_jsmnStream_end(self);
+
+	return ret;
+}
@@ -26,6 +26,7 @@
 
 #include <stdint.h>
 
+#include "../cc_memory.h"
 #include "cc_jsmnWrapper.h"
 
 #define CC_JSMN_STREAM_MAX_DEPTH 32
@@ -69,5 +70,10 @@ int              cc_jsmnStream_float(cc_jsmnStream_t* self,
                                      float val);
 int              cc_jsmnStream_double(cc_jsmnStream_t* self,
                                       double val);
+int              cc_jsmnStream_uint64(cc_jsmnStream_t* self,
+                                      uint64_t val);
+int              cc_jsmnStream_memstats(cc_jsmnStream_t* self,
+                                        const cc_memstats_t* prev,
+                                        const cc_memstats_t* stats);
 
 #endif
@@ -27,6 +27,7 @@
 #define LOG_TAG "cc"
 #include "../cc_log.h"
 #include "../cc_memory.h"
+#include "../cc_slab.h"
 #include "cc_jsmnWrapper.h"
 
 // import the jsmn implementation
@@ -38,6 +39,7 @@ typedef struct
 	// arguments
 	const char* str;
 	size_t      len;
+	cc_arena_t* arena;
 
 	// parser
 	jsmn_parser parser;
@@ -60,8 +62,10 @@ static void             cc_jsmnKeyval_delete(cc_jsmnKeyval_t** _self);
 ***********************************************************/
 
 static cc_jsmnWrapper_t*
-cc_jsmnWrapper_new(const char* str, size_t len)
+cc_jsmnWrapper_new(cc_arena_t* arena,
+                   const char* str, size_t len)
 {
+	// arena may be NULL
 	ASSERT(str);
 
 	cc_jsmnWrapper_t* self;
@@ -73,8 +77,9 @@ cc_jsmnWrapper_new(const char* str, size_t len)
 		return NULL;
 	}
 
-	self->str = str,
-	self->len = len,
+	self->str   = str;
+	self->len   = len;
+	self->arena = arena;
 
 	jsmn_init(&self->parser);
 	self->count = jsmn_parse(&self->parser, str, len, NULL, 0);
@@ -128,6 +133,72 @@ cc_jsmnWrapper_delete(cc_jsmnWrapper_t** _self)
 	}
 }
 
+static void*
+cc_jsmnWrapper_calloc(cc_jsmnWrapper_t* self,
+                      size_t count, size_t size)
+{
+	ASSERT(self);
+
+	if(self->arena)
+	{
+		return cc_arena_calloc(self->arena, count, size);
+	}
+
+	return CALLOC_TAG(CC_MEMTAG_JSMN, count, size);
+}
+
+static void
+cc_jsmnWrapper_free(cc_jsmnWrapper_t* self, void* ptr)
+{
+	// ptr may be NULL
+	ASSERT(self);
+
+	// arena memory is released by cc_jsmnVal_newArena
+	if(self->arena == NULL)
+	{
+		FREE(ptr);
+	}
+}
+
+static void*
+cc_jsmnWrapper_node(cc_jsmnWrapper_t* self, size_t size)
+{
+	ASSERT(self);
+
+	if(self->arena)
+	{
+		return cc_arena_calloc(self->arena, 1, size);
+	}
+
+	return cc_slab_callocTag(CC_MEMTAG_JSMN, size);
+}
+
+static void
+cc_jsmnWrapper_freeNode(cc_jsmnWrapper_t* self, void* ptr,
+                        size_t size)
+{
+	ASSERT(self);
+	ASSERT(ptr);
+
+	// arena memory is released by cc_jsmnVal_newArena
+	if(self->arena == NULL)
+	{
+		cc_slab_freeTag(CC_MEMTAG_JSMN, ptr, size);
+	}
+}
+
+static cc_list_t* cc_jsmnWrapper_list(cc_jsmnWrapper_t* self)
+{
+	ASSERT(self);
+
+	if(self->arena)
+	{
+		return cc_list_newArena(self->arena);
+	}
+
+	return cc_list_new();
+}
+
 static jsmntok_t*
 cc_jsmnWrapper_step(cc_jsmnWrapper_t* self, char** _data)
 {
@@ -146,7 +217,9 @@ cc_jsmnWrapper_step(cc_jsmnWrapper_t* self, char** _data)
 	   (tok->type == JSMN_PRIMITIVE))
 	{
 		size_t len  = tok->end - tok->start;
-		char*  data = CALLOC(len + 1, sizeof(char));
+		char*  data;
+		data = (char*)
+		       cc_jsmnWrapper_calloc(self, len + 1, sizeof(char));
 		if(data == NULL)
 		{
 			LOGE("CALLOC failed");
@@ -189,14 +262,14 @@ cc_jsmnObject_wrap(cc_jsmnWrapper_t* jw)
 
 	cc_jsmnObject_t* self;
 	self = (cc_jsmnObject_t*)
-	       CALLOC(1, sizeof(cc_jsmnObject_t));
+	       cc_jsmnWrapper_node(jw, sizeof(cc_jsmnObject_t));
 	if(self == NULL)
 	{
 		LOGE("CALLOC failed");
 		return NULL;
 	}
 
-	self->list = cc_list_new();
+	self->list = cc_jsmnWrapper_list(jw);
 	if(self->list == NULL)
 	{
 		goto fail_list;
@@ -237,7 +310,12 @@ cc_jsmnObject_wrap(cc_jsmnWrapper_t* jw)
 
 	// failure
 	fail_append:
-		cc_jsmnKeyval_delete(&kv);
+	{
+		if(jw->arena == NULL)
+		{
+			cc_jsmnKeyval_delete(&kv);
+		}
+	}
 	fail_kv:
 	{
 		cc_listIter_t* iter;
@@ -246,15 +324,19 @@ cc_jsmnObject_wrap(cc_jsmnWrapper_t* jw)
 		{
 			kv = (cc_jsmnKeyval_t*)
 			     cc_list_remove(self->list, &iter);
-			cc_jsmnKeyval_delete(&kv);
+			if(jw->arena == NULL)
+			{
+				cc_jsmnKeyval_delete(&kv);
+			}
 		}
 	}
 	fail_type:
-		FREE(str);
+		cc_jsmnWrapper_free(jw, str);
 	fail_tok:
 		cc_list_delete(&self->list);
 	fail_list:
-		FREE(self);
+		cc_jsmnWrapper_freeNode(jw, self,
+		                        sizeof(cc_jsmnObject_t));
 	return NULL;
 }
 
@@ -275,7 +357,8 @@ static void cc_jsmnObject_delete(cc_jsmnObject_t** _self)
 		}
 
 		cc_list_delete(&self->list);
-		FREE(self);
+		cc_slab_freeTag(CC_MEMTAG_JSMN, self,
+		                sizeof(cc_jsmnObject_t));
 		*_self = NULL;
 	}
 }
@@ -287,14 +370,14 @@ cc_jsmnArray_wrap(cc_jsmnWrapper_t* jw)
 
 	cc_jsmnArray_t* self;
 	self = (cc_jsmnArray_t*)
-	       CALLOC(1, sizeof(cc_jsmnArray_t));
+	       cc_jsmnWrapper_node(jw, sizeof(cc_jsmnArray_t));
 	if(self == NULL)
 	{
 		LOGE("CALLOC failed");
 		return NULL;
 	}
 
-	self->list = cc_list_new();
+	self->list = cc_jsmnWrapper_list(jw);
 	if(self->list == NULL)
 	{
 		goto fail_list;
@@ -335,7 +418,12 @@ cc_jsmnArray_wrap(cc_jsmnWrapper_t* jw)
 
 	// failure
 	fail_append:
-		cc_jsmnVal_delete(&val);
+	{
+		if(jw->arena == NULL)
+		{
+			cc_jsmnVal_delete(&val);
+		}
+	}
 	fail_val:
 	{
 		cc_listIter_t* iter;
@@ -344,15 +432,19 @@ cc_jsmnArray_wrap(cc_jsmnWrapper_t* jw)
 		{
 			val = (cc_jsmnVal_t*)
 			      cc_list_remove(self->list, &iter);
-			cc_jsmnVal_delete(&val);
+			if(jw->arena == NULL)
+			{
+				cc_jsmnVal_delete(&val);
+			}
 		}
 	}
 	fail_type:
-		FREE(str);
+		cc_jsmnWrapper_free(jw, str);
 	fail_tok:
 		cc_list_delete(&self->list);
 	fail_list:
-		FREE(self);
+		cc_jsmnWrapper_freeNode(jw, self,
+		                        sizeof(cc_jsmnArray_t));
 	return NULL;
 }
 
@@ -373,7 +465,8 @@ static void cc_jsmnArray_delete(cc_jsmnArray_t** _self)
 		}
 
 		cc_list_delete(&self->list);
-		FREE(self);
+		cc_slab_freeTag(CC_MEMTAG_JSMN, self,
+		                sizeof(cc_jsmnArray_t));
 		*_self = NULL;
 	}
 }
@@ -385,7 +478,7 @@ cc_jsmnVal_wrap(cc_jsmnWrapper_t* jw)
 
 	cc_jsmnVal_t* self;
 	self = (cc_jsmnVal_t*)
-	       CALLOC(1, sizeof(cc_jsmnVal_t));
+	       cc_jsmnWrapper_node(jw, sizeof(cc_jsmnVal_t));
 	if(self == NULL)
 	{
 		LOGE("CALLOC failed");
@@ -434,9 +527,10 @@ cc_jsmnVal_wrap(cc_jsmnWrapper_t* jw)
 
 	// failure
 	fail_val:
-		FREE(str);
+		cc_jsmnWrapper_free(jw, str);
 	fail_tok:
-		FREE(self);
+		cc_jsmnWrapper_freeNode(jw, self,
+		                        sizeof(cc_jsmnVal_t));
 	return NULL;
 }
 
@@ -447,7 +541,7 @@ cc_jsmnKeyval_wrap(cc_jsmnWrapper_t* jw)
 
 	cc_jsmnKeyval_t* self;
 	self = (cc_jsmnKeyval_t*)
-	       CALLOC(1, sizeof(cc_jsmnKeyval_t));
+	       cc_jsmnWrapper_node(jw, sizeof(cc_jsmnKeyval_t));
 	if(self == NULL)
 	{
 		LOGE("CALLOC failed");
@@ -478,9 +572,10 @@ cc_jsmnKeyval_wrap(cc_jsmnWrapper_t* jw)
 	// failure
 	fail_val:
 	fail_type:
-		FREE(self->key);
+		cc_jsmnWrapper_free(jw, self->key);
 	fail_tok:
-		FREE(self);
+		cc_jsmnWrapper_freeNode(jw, self,
+		                        sizeof(cc_jsmnKeyval_t));
 	return NULL;
 }
 
@@ -493,7 +588,8 @@ static void cc_jsmnKeyval_delete(cc_jsmnKeyval_t** _self)
 	{
 		cc_jsmnVal_delete(&self->val);
 		FREE(self->key);
-		FREE(self);
+		cc_slab_freeTag(CC_MEMTAG_JSMN, self,
+		                sizeof(cc_jsmnKeyval_t));
 		*_self = NULL;
 	}
 }
@@ -590,7 +686,7 @@ cc_jsmnVal_new(const char* str, size_t len)
 {
 	ASSERT(str);
 
-	cc_jsmnWrapper_t* jw = cc_jsmnWrapper_new(str, len);
+	cc_jsmnWrapper_t* jw = cc_jsmnWrapper_new(NULL, str, len);
 	if(jw == NULL)
 	{
 		return NULL;
@@ -613,6 +709,40 @@ cc_jsmnVal_new(const char* str, size_t len)
 	return NULL;
 }
 
+cc_jsmnVal_t*
+cc_jsmnVal_newArena(cc_arena_t* arena,
+                    const char* str, size_t len)
+{
+	ASSERT(arena);
+	ASSERT(str);
+
+	cc_jsmnWrapper_t* jw = cc_jsmnWrapper_new(arena, str, len);
+	if(jw == NULL)
+	{
+		return NULL;
+	}
+
+	cc_arenaMark_t mark;
+	cc_arena_mark(arena, &mark);
+
+	cc_jsmnVal_t* self = cc_jsmnVal_wrap(jw);
+	if(self == NULL)
+	{
+		goto fail_val;
+	}
+
+	cc_jsmnWrapper_delete(&jw);
+
+	// success
+	return self;
+
+	// failure
+	fail_val:
+		cc_arena_rewind(arena, &mark);
+		cc_jsmnWrapper_delete(&jw);
+	return NULL;
+}
+
 cc_jsmnVal_t* cc_jsmnVal_import(const char* fname)
 {
 	ASSERT(fname);
@@ -697,7 +827,8 @@ void cc_jsmnVal_delete(cc_jsmnVal_t** _self)
 			FREE(self->data);
 		}
 
-		FREE(self);
+		cc_slab_freeTag(CC_MEMTAG_JSMN, self,
+		                sizeof(cc_jsmnVal_t));
 		*_self = NULL;
 	}
 }
@@ -24,6 +24,7 @@
 #ifndef cc_jsmnWrapper_H
 #define cc_jsmnWrapper_H
 
+#include "../cc_arena.h"
 #include "../cc_list.h"
 
 typedef enum
@@ -65,7 +66,12 @@ typedef struct
 	cc_jsmnVal_t* val;
 } cc_jsmnKeyval_t;
 
+// vals created with an arena are owned by the arena and
+// must be released with cc_arena_reset/rewind/delete rather
+// than cc_jsmnVal_delete
 cc_jsmnVal_t* cc_jsmnVal_new(const char* str, size_t len);
+cc_jsmnVal_t* cc_jsmnVal_newArena(cc_arena_t* arena,
+                                  const char* str, size_t len);
 cc_jsmnVal_t* cc_jsmnVal_import(const char* fname);
 void          cc_jsmnVal_delete(cc_jsmnVal_t** _self);
 void          cc_jsmnVal_print(cc_jsmnVal_t* val);
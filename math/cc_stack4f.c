@@ -27,6 +27,7 @@
 #define LOG_TAG "cc"
 #include "../cc_log.h"
 #include "../cc_memory.h"
+#include "../cc_slab.h"
 #include "cc_stack4f.h"
 
 /***********************************************************
@@ -42,7 +43,7 @@ cc_stack4f_t* cc_stack4f_new(void)
 		return NULL;
 	}
 
-	self->matrix_stack = cc_list_new();
+	self->matrix_stack = cc_vector_new();
 	if(self->matrix_stack == NULL)
 	{
 		goto fail_matrix_stack;
@@ -65,15 +66,14 @@ void cc_stack4f_delete(cc_stack4f_t** _self)
 	cc_stack4f_t* self = *_self;
 	if(self)
 	{
-		cc_listIter_t* iter = cc_list_head(self->matrix_stack);
-		while(iter)
+		cc_mat4f_t* m;
+		m = (cc_mat4f_t*) cc_vector_pop(self->matrix_stack);
+		while(m)
 		{
-			cc_mat4f_t* m;
-			m = (cc_mat4f_t*)
-			    cc_list_remove(self->matrix_stack, &iter);
-			FREE(m);
+			cc_slab_free(m, sizeof(cc_mat4f_t));
+			m = (cc_mat4f_t*) cc_vector_pop(self->matrix_stack);
 		}
-		cc_list_delete(&self->matrix_stack);
+		cc_vector_delete(&self->matrix_stack);
 		FREE(self);
 		*_self = NULL;
 	}
@@ -84,14 +84,19 @@ void cc_stack4f_push(cc_stack4f_t* self, const cc_mat4f_t* m)
 	ASSERT(self);
 	ASSERT(m);
 
-	cc_mat4f_t* c = (cc_mat4f_t*) CALLOC(1, sizeof(cc_mat4f_t));
+	cc_mat4f_t* c;
+	c = (cc_mat4f_t*) cc_slab_alloc(sizeof(cc_mat4f_t));
 	if(c == NULL)
 	{
-		LOGE("CALLOC failed");
+		LOGE("cc_slab_alloc failed");
 		return;
 	}
 	cc_mat4f_copy(m, c);
-	cc_list_insert(self->matrix_stack, NULL, (const void*) c);
+	if(cc_vector_append(self->matrix_stack,
+	                    (const void*) c) == 0)
+	{
+		cc_slab_free(c, sizeof(cc_mat4f_t));
+	}
 }
 
 void cc_stack4f_pop(cc_stack4f_t* self, cc_mat4f_t* m)
@@ -99,13 +104,11 @@ void cc_stack4f_pop(cc_stack4f_t* self, cc_mat4f_t* m)
 	ASSERT(self);
 	ASSERT(m);
 
-	cc_listIter_t* iter = cc_list_head(self->matrix_stack);
-	if(iter)
+	cc_mat4f_t* c;
+	c = (cc_mat4f_t*) cc_vector_pop(self->matrix_stack);
+	if(c)
 	{
-		cc_mat4f_t* c;
-		c = (cc_mat4f_t*)
-		    cc_list_remove(self->matrix_stack, &iter);
 		cc_mat4f_copy(c, m);
-		FREE(c);
+		cc_slab_free(c, sizeof(cc_mat4f_t));
 	}
 }
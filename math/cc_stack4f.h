@@ -24,12 +24,12 @@
 #ifndef cc_stack4f_H
 #define cc_stack4f_H
 
-#include "../cc_list.h"
+#include "../cc_vector.h"
 #include "cc_mat4f.h"
 
 typedef struct
 {
-	cc_list_t* matrix_stack;
+	cc_vector_t* matrix_stack;
 } cc_stack4f_t;
 
 cc_stack4f_t* cc_stack4f_new(void);